@@ -0,0 +1,114 @@
+#pragma once
+
+#include "components.hpp"
+#include "entity.hpp"
+#include "memory.hpp"
+
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+using component_mask = uint32_t;
+
+template <typename... Cs>
+struct component_list {
+  static_assert(sizeof...(Cs) <= sizeof(component_mask) * 8);
+
+  template <typename C>
+  static constexpr bool contains() noexcept {
+    return (std::is_same_v<std::remove_const_t<C>, Cs> || ...);
+  }
+
+  template <typename C>
+  static constexpr component_mask bit() noexcept {
+    uint32_t idx = 0;
+    const bool found = ((std::is_same_v<std::remove_const_t<C>, Cs> ? true : (++idx, false)) || ...);
+    static_assert(((std::is_same_v<std::remove_const_t<C>, Cs>) || ...), "not a registered component");
+    return found ? component_mask{1} << idx : 0;
+  }
+
+  template <typename... Ts>
+  static constexpr component_mask mask() noexcept {
+    return (component_mask{0} | ... | bit<Ts>());
+  }
+
+  static constexpr component_mask all() noexcept { return mask<Cs...>(); }
+
+  template <typename F>
+  static void for_each(F&& f) {
+    (f.template operator()<Cs>(), ...);
+  }
+
+  template <typename C>
+  using column = chunked_vector<C>;
+
+  using columns = std::tuple<column<Cs>...>;
+};
+
+using components = component_list<position, previous_position, object_size, texture_size, motion, drag, mouse_tracker, drawable, text_label, draggable,
+                                  clickable, trigger_zone>;
+
+// table of all entities sharing one component set; one chunked column per component, rows aligned. Columns never
+// move their elements, so component references stay valid while other rows are added.
+struct archetype {
+  static constexpr uint32_t kChunkRows = chunked_vector<entity>::kChunkRows;
+
+  component_mask mask = 0;
+  chunked_vector<entity> entities;
+  components::columns columns;
+
+  template <typename C>
+  [[nodiscard]] components::column<C>& column() noexcept {
+    return std::get<components::column<C>>(columns);
+  }
+  template <typename C>
+  [[nodiscard]] const components::column<C>& column() const noexcept {
+    return std::get<components::column<C>>(columns);
+  }
+
+  // allocates every column of the table for `rows` rows
+  void reserve(uint32_t rows) {
+    entities.reserve(rows);
+    components::for_each([&]<typename C>() {
+      if (mask & components::bit<C>()) {
+        column<C>().reserve(rows);
+      }
+    });
+  }
+
+  void clear() noexcept {
+    entities.clear();
+    components::for_each([&]<typename C>() { column<C>().clear(); });
+  }
+
+  // sets the row count of every column; new rows are uninitialized until the caller fills them
+  void resize_for_overwrite(uint32_t rows) {
+    entities.resize_for_overwrite(rows);
+    components::for_each([&]<typename C>() {
+      if (mask & components::bit<C>()) {
+        column<C>().resize_for_overwrite(rows);
+      }
+    });
+  }
+
+  [[nodiscard]] bool has(component_mask m) const noexcept { return (mask & m) == m; }
+  [[nodiscard]] uint32_t size() const noexcept { return static_cast<uint32_t>(entities.size()); }
+
+  // swap-and-pop; returns the entity moved into `row`, or null if `row` was last
+  entity remove_row(uint32_t row) noexcept {
+    components::for_each([&]<typename C>() {
+      if (mask & components::bit<C>()) {
+        auto& col = column<C>();
+        col[row] = std::move(col.back());
+        col.pop_back();
+      }
+    });
+
+    const bool was_last = row + 1 == entities.size();
+    entities[row] = entities.back();
+    entities.pop_back();
+
+    return was_last ? entity::null() : entities[row];
+  }
+};
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include "log.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Pre-decoded image pack written by pack_assets at build time:
+//
+//   header | entry[count] | pixel blobs, each starting on a kAlignment boundary
+//
+// Pixels are ARGB8888, the atlas page format. Images that fit a page are stored already extruded (padding ==
+// kAtlasPadding) so they upload into the atlas as-is. Fields are native-endian; the pack is built for the machine
+// that runs it.
+namespace asset_pack {
+
+constexpr uint32_t kMagic = 0x4B504541;  // "AEPK"
+constexpr uint32_t kVersion = 1;
+constexpr uint64_t kAlignment = 4096;
+constexpr std::size_t kNameLength = 48;
+
+struct header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t count;
+  uint32_t format;  // SDL_PixelFormat of every blob
+};
+
+struct entry {
+  char name[kNameLength];  // nul-terminated
+  uint32_t width;          // stored size, padding included
+  uint32_t height;
+  uint32_t pitch;
+  uint32_t padding;
+  uint64_t offset;  // from the start of the file
+  uint64_t size;
+};
+
+static_assert(sizeof(header) == 16);
+static_assert(sizeof(entry) == 80);
+
+constexpr uint64_t align_up(uint64_t v) noexcept {
+  return (v + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+// read-only mapping of a whole pack; open() validates the table so callers can trust every entry
+class mapped_pack {
+ public:
+  mapped_pack() = default;
+  mapped_pack(const mapped_pack&) = delete;
+  mapped_pack& operator=(const mapped_pack&) = delete;
+
+  ~mapped_pack() { close(); }
+
+  bool open(const char* path) noexcept {
+    close();
+    if (!map(path)) {
+      return false;
+    }
+
+    if (!valid()) {
+      LOG_ERROR("Asset pack %s is corrupt or from another version\n", path);
+      close();
+      return false;
+    }
+    return true;
+  }
+
+  [[nodiscard]] std::span<const entry> entries() const noexcept {
+    const auto* head = reinterpret_cast<const header*>(data_);
+    return {reinterpret_cast<const entry*>(data_ + sizeof(header)), head->count};
+  }
+
+  [[nodiscard]] const void* pixels(const entry& e) const noexcept { return data_ + e.offset; }
+
+ private:
+  bool valid() const noexcept {
+    if (size_ < sizeof(header)) {
+      return false;
+    }
+
+    const auto* head = reinterpret_cast<const header*>(data_);
+    if (head->magic != kMagic || head->version != kVersion || head->format != SDL_PIXELFORMAT_ARGB8888) {
+      return false;
+    }
+    if (sizeof(header) + static_cast<uint64_t>(head->count) * sizeof(entry) > size_) {
+      return false;
+    }
+
+    for (const auto& e : entries()) {
+      if (std::memchr(e.name, '\0', kNameLength) == nullptr || e.width == 0 || e.height == 0 || e.pitch < e.width * sizeof(uint32_t) ||
+          e.width <= 2 * e.padding || e.height <= 2 * e.padding) {
+        return false;
+      }
+      if (e.offset % kAlignment != 0 || e.size < static_cast<uint64_t>(e.pitch) * e.height || e.offset > size_ || e.size > size_ - e.offset) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+#if defined(_WIN32)
+  bool map(const char* path) noexcept {
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+      return false;
+    }
+
+    LARGE_INTEGER size{};
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+      mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    CloseHandle(file);
+    if (mapping == nullptr) {
+      return false;
+    }
+
+    data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);  // the view keeps the mapping alive
+    size_ = data_ != nullptr ? static_cast<uint64_t>(size.QuadPart) : 0;
+    return data_ != nullptr;
+  }
+
+  void close() noexcept {
+    if (data_ != nullptr) {
+      UnmapViewOfFile(data_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+  }
+#else
+  bool map(const char* path) noexcept {
+    const int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+
+    struct stat st{};
+    void* addr = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      addr = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);  // the mapping outlives the descriptor
+    if (addr == MAP_FAILED) {
+      return false;
+    }
+
+    data_ = static_cast<const uint8_t*>(addr);
+    size_ = static_cast<uint64_t>(st.st_size);
+    return true;
+  }
+
+  void close() noexcept {
+    if (data_ != nullptr) {
+      munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+  }
+#endif
+
+  const uint8_t* data_ = nullptr;
+  uint64_t size_ = 0;
+};
+
+}  // namespace asset_pack
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include "log.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// Watches an asset directory for images that were written or moved into place, on a thread of its own. The frame
+// thread drains the changed paths between frames; it never waits on the filesystem. Each change also posts an
+// SDL_EVENT_USER, so an idle game loop wakes up for it.
+//
+// inotify only: elsewhere start() fails and there is nothing to drain.
+class asset_watcher {
+ public:
+  asset_watcher() = default;
+  asset_watcher(const asset_watcher&) = delete;
+  asset_watcher& operator=(const asset_watcher&) = delete;
+
+  ~asset_watcher() { stop(); }
+
+  bool start(const char* dir) noexcept {
+#if defined(__linux__)
+    stop();
+    dir_ = dir;
+
+    notify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notify_fd_ < 0 || inotify_add_watch(notify_fd_, dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0 || pipe2(stop_pipe_, O_CLOEXEC) != 0) {
+      LOG_ERROR("Unable to watch %s for changes\n", dir);
+      close_fds();
+      return false;
+    }
+
+    thread_ = std::thread([this] { run(); });
+    LOG_INFO("Watching %s for changed images\n", dir);
+    return true;
+#else
+    LOG_WARN("Unable to watch %s: asset watching needs inotify\n", dir);
+    return false;
+#endif
+  }
+
+  void stop() noexcept {
+#if defined(__linux__)
+    if (thread_.joinable()) {
+      const char wake = 0;
+      [[maybe_unused]] const auto written = write(stop_pipe_[1], &wake, 1);
+      thread_.join();
+    }
+    close_fds();
+#endif
+  }
+
+  // f(path) for every image changed since the last drain, each once; frame thread
+  template <typename F>
+  void drain(F&& f) {
+    {
+      std::lock_guard lock{changed_mutex_};
+      if (changed_.empty()) {
+        return;
+      }
+      std::swap(draining_, changed_);
+    }
+    for (const auto& path : draining_) {
+      f(path);
+    }
+    draining_.clear();
+  }
+
+ private:
+#if defined(__linux__)
+  void run() noexcept {
+    alignas(inotify_event) char buffer[4096];
+    pollfd fds[2] = {{notify_fd_, POLLIN, 0}, {stop_pipe_[0], POLLIN, 0}};
+
+    for (;;) {
+      if (poll(fds, 2, -1) < 0 || (fds[1].revents & POLLIN) != 0) {
+        return;
+      }
+
+      bool changed = false;
+      for (ssize_t n; (n = read(notify_fd_, buffer, sizeof(buffer))) > 0;) {
+        for (ssize_t at = 0; at < n;) {
+          const auto* ev = reinterpret_cast<const inotify_event*>(buffer + at);
+          at += static_cast<ssize_t>(sizeof(inotify_event) + ev->len);
+          if (ev->len != 0 && std::string_view{ev->name}.ends_with(".png")) {
+            changed = queue(dir_ + '/' + ev->name) || changed;
+          }
+        }
+      }
+
+      if (changed) {
+        SDL_Event wake{};
+        wake.type = SDL_EVENT_USER;
+        SDL_PushEvent(&wake);
+      }
+    }
+  }
+
+  // an editor's save can be several events; one reload covers them
+  bool queue(std::string path) {
+    std::lock_guard lock{changed_mutex_};
+    if (std::find(changed_.begin(), changed_.end(), path) != changed_.end()) {
+      return false;
+    }
+    changed_.emplace_back(std::move(path));
+    return true;
+  }
+
+  void close_fds() noexcept {
+    for (int* fd : {&notify_fd_, &stop_pipe_[0], &stop_pipe_[1]}) {
+      if (*fd >= 0) {
+        close(*fd);
+        *fd = -1;
+      }
+    }
+  }
+
+  int notify_fd_ = -1;
+  int stop_pipe_[2] = {-1, -1};
+#endif
+
+  std::string dir_;
+  std::thread thread_;
+
+  std::mutex changed_mutex_;
+  std::vector<std::string> changed_;   // guarded by changed_mutex_
+  std::vector<std::string> draining_;  // frame thread only
+};
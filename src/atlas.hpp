@@ -0,0 +1,167 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+inline constexpr int kAtlasSize = 2048;
+inline constexpr int kAtlasPadding = 1;  // extruded border against filtering bleed
+
+inline bool fits_atlas(int w, int h) noexcept {
+  return w + 2 * kAtlasPadding <= kAtlasSize && h + 2 * kAtlasPadding <= kAtlasSize;
+}
+
+// ARGB8888 copy with a kAtlasPadding border that repeats the edge pixels
+inline SDL_Surface* extrude(SDL_Surface* src) noexcept {
+  SDL_Surface* converted = SDL_ConvertSurface(src, SDL_PIXELFORMAT_ARGB8888);
+  if (converted == nullptr) {
+    return nullptr;
+  }
+
+  const int w = src->w, h = src->h, p = kAtlasPadding;
+  SDL_Surface* out = SDL_CreateSurface(w + 2 * p, h + 2 * p, SDL_PIXELFORMAT_ARGB8888);
+  if (out != nullptr) {
+    const auto* in_px = static_cast<const uint8_t*>(converted->pixels);
+    auto* out_px = static_cast<uint8_t*>(out->pixels);
+    for (int y = 0; y < h + 2 * p; ++y) {
+      const auto* src_row = reinterpret_cast<const uint32_t*>(in_px + std::clamp(y - p, 0, h - 1) * converted->pitch);
+      auto* dst_row = reinterpret_cast<uint32_t*>(out_px + y * out->pitch);
+      for (int x = 0; x < w + 2 * p; ++x) {
+        dst_row[x] = src_row[std::clamp(x - p, 0, w - 1)];
+      }
+    }
+  }
+
+  SDL_DestroySurface(converted);
+  return out;
+}
+
+// skyline bottom-left rectangle packer for atlas pages. Released rectangles go on a free list that later inserts try
+// first, splitting off what they do not use.
+class skyline_packer {
+ public:
+  skyline_packer(int width, int height) noexcept : width_{width}, height_{height}, skyline_{{0, 0, width}} {}
+
+  bool insert(int w, int h, SDL_Rect& out) noexcept {
+    if (take_free(w, h, out)) {
+      return true;
+    }
+
+    int best_bottom = std::numeric_limits<int>::max();
+    int best_x = std::numeric_limits<int>::max();
+    std::size_t best = skyline_.size();
+
+    for (std::size_t i = 0; i < skyline_.size(); ++i) {
+      if (const int y = fit(i, w, h); y >= 0) {
+        if (y + h < best_bottom || (y + h == best_bottom && skyline_[i].x < best_x)) {
+          best_bottom = y + h;
+          best_x = skyline_[i].x;
+          best = i;
+        }
+      }
+    }
+
+    if (best == skyline_.size()) {
+      return false;
+    }
+
+    out = {skyline_[best].x, best_bottom - h, w, h};
+    skyline_.insert(skyline_.begin() + best, {out.x, best_bottom, w});
+
+    // clip the segments now covered by the new one
+    for (std::size_t i = best + 1; i < skyline_.size();) {
+      const auto& prev = skyline_[i - 1];
+      auto& cur = skyline_[i];
+      if (cur.x >= prev.x + prev.w) {
+        break;
+      }
+
+      const int shrink = prev.x + prev.w - cur.x;
+      cur.x += shrink;
+      cur.w -= shrink;
+      if (cur.w > 0) {
+        break;
+      }
+      skyline_.erase(skyline_.begin() + i);
+    }
+
+    merge();
+    return true;
+  }
+
+  // `r` came from insert() and is no longer used
+  void release(const SDL_Rect& r) noexcept { free_.push_back(r); }
+
+ private:
+  struct segment {
+    int x;
+    int y;
+    int w;
+  };
+
+  // top of the stack a w x h box would rest on when its left edge is at segment i, or -1
+  int fit(std::size_t i, int w, int h) const noexcept {
+    if (skyline_[i].x + w > width_) {
+      return -1;
+    }
+
+    int y = 0;
+    int remaining = w;
+    for (std::size_t j = i; remaining > 0; ++j) {
+      y = std::max(y, skyline_[j].y);
+      if (y + h > height_) {
+        return -1;
+      }
+      remaining -= skyline_[j].w;
+    }
+    return y;
+  }
+
+  // best short-side fit among released rectangles; the rest of it is split in two, keeping the larger leftover whole
+  bool take_free(int w, int h, SDL_Rect& out) noexcept {
+    std::size_t best = free_.size();
+    int best_fit = std::numeric_limits<int>::max();
+    for (std::size_t i = 0; i < free_.size(); ++i) {
+      if (const auto& r = free_[i]; r.w >= w && r.h >= h && std::min(r.w - w, r.h - h) < best_fit) {
+        best_fit = std::min(r.w - w, r.h - h);
+        best = i;
+      }
+    }
+    if (best == free_.size()) {
+      return false;
+    }
+
+    const SDL_Rect r = free_[best];
+    free_.erase(free_.begin() + best);
+    out = {r.x, r.y, w, h};
+
+    const bool wide = r.w - w > r.h - h;
+    const SDL_Rect right{r.x + w, r.y, r.w - w, wide ? r.h : h};
+    const SDL_Rect below{r.x, r.y + h, wide ? w : r.w, r.h - h};
+    for (const auto& rest : {right, below}) {
+      if (rest.w > 0 && rest.h > 0) {
+        free_.push_back(rest);
+      }
+    }
+    return true;
+  }
+
+  void merge() noexcept {
+    for (std::size_t i = 1; i < skyline_.size();) {
+      if (skyline_[i - 1].y == skyline_[i].y) {
+        skyline_[i - 1].w += skyline_[i].w;
+        skyline_.erase(skyline_.begin() + i);
+      } else {
+        ++i;
+      }
+    }
+  }
+
+  int width_;
+  int height_;
+  std::vector<segment> skyline_;
+  std::vector<SDL_Rect> free_;
+};
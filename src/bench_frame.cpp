@@ -0,0 +1,466 @@
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include <SDL3_ttf/SDL_ttf.h>
+
+#include "ecs.hpp"
+#include "globals.hpp"
+#include "input.hpp"
+#include "job_system.hpp"
+#include "memory.hpp"
+#include "profiler.hpp"
+#include "replay.hpp"
+#include "scene.hpp"
+#include "scene_file.hpp"
+#include "scheduler.hpp"
+#include "simd.hpp"
+#include "texture.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Headless frame benchmark: runs game_loop-equivalent frames without a frame cap under SDL's dummy/offscreen video
+// driver and the software renderer, then prints per-system and whole-frame timings as JSON.
+//
+//   bench_frame [--frames N] [--warmup N] [--eyes N] [--draggables N] [--zones N] [--driver dummy|offscreen] [--out file]
+//               [--trace file]  (Chrome trace of the measured frames; needs AEOM_PROFILE)
+//               [--workers N]   (job threads besides the main one; 0 runs every system serially)
+//               [--replay file] (drive the frames from an input log recorded with AllEyesOnMe --record; runs the
+//                                whole log in the recorded scene and fails if any frame's state hash differs)
+//               [--max-allocs N] (fail if any measured frame makes more than N heap allocations; 0 asserts the
+//                                 steady state allocates nothing)
+//               [--scene file]  (load the scene from a file written with --save-scene instead of building it)
+//               [--save-scene file] (write the scene as set up, before the first frame)
+//               [--damage on|off|check] (dirty-rectangle redraws, on by default as in the game on the software
+//                                renderer; check also redraws every frame in full, without the layer caches or
+//                                pre-scaled copies, and fails if any pixel differs; it turns --prescale off)
+//               [--prescale MiB] (memory for copies of scaled sprites pre-resampled to their drawn size, 8 by
+//                                default as in the game on the software renderer; 0 resamples every frame)
+//               [--simd scalar|sse2|avx2] (kernel level for the trackers and integration, the best the CPU supports by
+//                                          default; a level the CPU lacks falls back to the next one down)
+//
+// Per-system timings come from the scheduler; systems that ran side by side overlap, so they can sum past "sim".
+
+AEOM_DEFINE_ALLOCATION_COUNTER()
+
+namespace {
+
+enum class damage_mode { off, on, check };
+
+struct bench_config {
+  uint32_t frames = 1000;
+  uint32_t warmup = 100;
+  scene_config scene;
+  std::string driver = "dummy";
+  std::string out;
+  std::string trace;
+  uint32_t workers = job_system::default_workers();
+  std::string replay;
+  damage_mode damage = damage_mode::on;
+  int64_t max_allocs = -1;  // no limit
+  std::string scene_file;
+  std::string save_scene;
+  std::size_t prescale_bytes = texture_manager::kDefaultScaledBudget;
+  std::optional<simd::level> simd_level;  // best supported
+};
+
+bool parse_args(int argc, char* argv[], bench_config& cfg) noexcept {
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg{argv[i]};
+    if (i + 1 >= argc) {
+      SDL_Log("missing value for %s\n", argv[i]);
+      return false;
+    }
+
+    const char* value = argv[++i];
+    const auto number = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+    if (arg == "--frames") {
+      cfg.frames = std::max(number, 1u);
+    } else if (arg == "--warmup") {
+      cfg.warmup = number;
+    } else if (arg == "--eyes") {
+      cfg.scene.crowd_eyes = number;
+    } else if (arg == "--draggables") {
+      cfg.scene.draggables = number;
+    } else if (arg == "--zones") {
+      cfg.scene.zones = number;
+    } else if (arg == "--driver") {
+      cfg.driver = value;
+    } else if (arg == "--out") {
+      cfg.out = value;
+    } else if (arg == "--trace") {
+      cfg.trace = value;
+    } else if (arg == "--workers") {
+      cfg.workers = number;
+    } else if (arg == "--replay") {
+      cfg.replay = value;
+    } else if (arg == "--max-allocs") {
+      cfg.max_allocs = number;
+    } else if (arg == "--scene") {
+      cfg.scene_file = value;
+    } else if (arg == "--save-scene") {
+      cfg.save_scene = value;
+    } else if (arg == "--prescale") {
+      cfg.prescale_bytes = std::size_t{number} * 1024 * 1024;
+    } else if (arg == "--simd") {
+      const std::string_view level{value};
+      if (level != "scalar" && level != "sse2" && level != "avx2") {
+        SDL_Log("--simd takes scalar, sse2 or avx2\n");
+        return false;
+      }
+      cfg.simd_level = level == "scalar" ? simd::level::scalar : level == "sse2" ? simd::level::sse2 : simd::level::avx2;
+    } else if (arg == "--damage") {
+      const std::string_view mode{value};
+      if (mode != "on" && mode != "off" && mode != "check") {
+        SDL_Log("--damage takes on, off or check\n");
+        return false;
+      }
+      cfg.damage = mode == "off" ? damage_mode::off : mode == "on" ? damage_mode::on : damage_mode::check;
+    } else {
+      SDL_Log("unknown argument %s\n", argv[i - 1]);
+      return false;
+    }
+  }
+  return true;
+}
+
+struct summary {
+  double p50_us;
+  double p99_us;
+  double max_us;
+  double mean_us;
+};
+
+summary summarize(std::vector<uint64_t>& samples) noexcept {
+  std::sort(samples.begin(), samples.end());
+
+  // nearest-rank percentile
+  auto percentile = [&](double p) {
+    const auto rank = static_cast<std::size_t>(p * static_cast<double>(samples.size()) + 0.999999);
+    return samples[std::clamp<std::size_t>(rank, 1, samples.size()) - 1] / 1000.0;
+  };
+
+  uint64_t total = 0;
+  for (const auto ns : samples) {
+    total += ns;
+  }
+
+  return {percentile(0.50), percentile(0.99), samples.back() / 1000.0, static_cast<double>(total) / samples.size() / 1000.0};
+}
+
+// synthetic input so trackers, hit tests, drags and the score path run; one tick per frame, as at the default cap
+void synthetic_input(uint32_t frame, input_frame& in) noexcept {
+  in.mouse = {static_cast<float>(frame * 7 % kScreenWidth), static_cast<float>(frame * 13 % kScreenHeight), 0, true};
+  in.events.assign(1, {input_event::kMotion, 0});
+  in.ticks = 1;
+
+  if (frame % 30 == 0) {
+    in.mouse.buttons = SDL_BUTTON_MASK(SDL_BUTTON_LEFT);
+    in.events.push_back({input_event::kButtonDown, SDL_BUTTON_LEFT});
+  } else if (frame % 30 == 1) {
+    in.events.push_back({input_event::kButtonUp, SDL_BUTTON_LEFT});
+  }
+}
+
+// reads back the frame ECS::render produced, redraws the same draw list in full, bypassing every cache, and compares
+bool matches_full_redraw(SDL_Renderer* renderer, ECS& ecs) noexcept {
+  SDL_Surface* damaged = SDL_RenderReadPixels(renderer, nullptr);
+  ecs.render_reference();
+  SDL_Surface* full = SDL_RenderReadPixels(renderer, nullptr);
+
+  bool same = damaged != nullptr && full != nullptr && damaged->w == full->w && damaged->h == full->h && damaged->format == full->format;
+  const auto row_bytes = same ? static_cast<std::size_t>(damaged->w) * SDL_BYTESPERPIXEL(damaged->format) : 0;
+  for (int y = 0; same && y < damaged->h; ++y) {
+    same = std::memcmp(static_cast<const uint8_t*>(damaged->pixels) + y * damaged->pitch, static_cast<const uint8_t*>(full->pixels) + y * full->pitch,
+                       row_bytes) == 0;
+  }
+
+  SDL_DestroySurface(damaged);
+  SDL_DestroySurface(full);
+  return same;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  bench_config cfg;
+  if (!parse_args(argc, argv, cfg)) {
+    return 1;
+  }
+
+  input_replay replay;
+  if (!cfg.replay.empty()) {
+    if (!replay.open(cfg.replay.c_str())) {
+      return 1;
+    }
+    cfg.scene = replay.scene();
+    if (!cfg.scene_file.empty()) {
+      SDL_Log("--replay runs in the recorded scene; ignoring --scene\n");
+      cfg.scene_file.clear();
+    }
+  }
+
+  if (cfg.damage == damage_mode::check && cfg.prescale_bytes != 0) {
+    // the reference draws from the original images, which pre-scaled copies only approximate
+    SDL_Log("--damage check redraws from the original images; turning --prescale off\n");
+    cfg.prescale_bytes = 0;
+  }
+
+  if (cfg.simd_level && simd::force_level(*cfg.simd_level) != *cfg.simd_level) {
+    SDL_Log("--simd %s is not supported here; using %s\n", simd::level_name(*cfg.simd_level), simd::level_name(simd::kernels().lvl));
+  }
+
+  SDL_SetHint(SDL_HINT_VIDEO_DRIVER, cfg.driver.c_str());
+  if (SDL_Init(SDL_INIT_VIDEO) == false) {
+    SDL_Log("SDL_Init failed: %s", SDL_GetError());
+    return 1;
+  }
+
+  if (TTF_Init() == false) {
+    SDL_Log("TTF_Init failed: %s\n", SDL_GetError());
+    return 2;
+  }
+
+  SDL_Window* window = SDL_CreateWindow("bench_frame", kScreenWidth, kScreenHeight, SDL_WINDOW_HIDDEN);
+  if (window == nullptr) {
+    SDL_Log("SDL_CreateWindow failed: %s", SDL_GetError());
+    SDL_Quit();
+    return 3;
+  }
+
+  SDL_Renderer* renderer = SDL_CreateRenderer(window, "software");
+  if (renderer == nullptr) {
+    SDL_Log("SDL_CreateRenderer failed: %s", SDL_GetError());
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return 3;
+  }
+  SDL_SetRenderVSync(renderer, SDL_RENDERER_VSYNC_DISABLED);
+
+  TTF_Font* font = nullptr;
+  std::string fontPath{"assets/press_start.ttf"};
+  if (font = TTF_OpenFont(fontPath.c_str(), 56); font == nullptr) {
+    SDL_Log("Could not load %s! SDL_ttf Error: %s\n", fontPath.c_str(), SDL_GetError());
+    return 4;
+  }
+
+  int rc = 0;
+  {
+    texture_manager manager;
+    load_assets(renderer, font, manager);
+    manager.set_scaled_budget(cfg.prescale_bytes);
+
+    ECS ecs(renderer, font, manager);
+    ecs.damage_tracking = cfg.damage != damage_mode::off;
+    game_state state{0, 0, false, 100};
+
+    const uint64_t setup_start = SDL_GetTicksNS();
+    if (cfg.scene_file.empty()) {
+      build_scene(ecs, state, manager, cfg.scene);
+    } else {
+      wire_scene(ecs, state);
+      rc = load_scene_file(cfg.scene_file.c_str(), ecs, state, manager) ? 0 : 10;
+      cfg.scene = {};
+    }
+    const uint64_t setup_ns = SDL_GetTicksNS() - setup_start;
+
+    if (rc == 0 && !cfg.save_scene.empty() && !save_scene_file(cfg.save_scene.c_str(), ecs, state, manager)) {
+      rc = 10;
+    }
+
+    job_system jobs(cfg.workers);
+    ecs.jobs = &jobs;
+    scheduler sim;
+    ecs.register_systems(sim, state);
+
+    std::vector<const char*> stage_names{"events", "cleanup"};
+    for (uint32_t i = 0; i < sim.size(); ++i) {
+      stage_names.emplace_back(sim.name(i));
+    }
+    for (const char* name : {"sim", "render", "present", "frame"}) {
+      stage_names.emplace_back(name);
+    }
+
+    std::vector<std::vector<uint64_t>> samples(stage_names.size());
+    for (auto& s : samples) {
+      s.reserve(cfg.frames);
+    }
+
+    uint64_t measured_ns = 0;
+    uint64_t draw_calls = 0;
+    uint64_t allocs = 0;
+    uint64_t max_frame_allocs = 0;
+    uint32_t over_budget = 0;
+    uint32_t measured = 0;
+    uint32_t mismatches = 0;
+    uint32_t first_mismatch = 0;
+    uint32_t damage_mismatches = 0;
+    uint32_t first_damage_mismatch = 0;
+
+    input_frame input;
+    std::vector<uint64_t> system_ns(sim.size());
+    for (uint32_t frame = 0; rc == 0; ++frame) {
+      if (!cfg.replay.empty() ? !replay.next(input) : frame >= cfg.warmup + cfg.frames) {
+        break;
+      }
+      if (cfg.replay.empty()) {
+        synthetic_input(frame, input);
+      }
+
+      PROFILE_FRAME();
+      ecs.begin_frame();
+      const uint64_t allocs_start = alloc_stats::count();
+      const uint64_t t_events = SDL_GetTicksNS();
+
+      SDL_Event e;
+      while (SDL_PollEvent(&e)) {
+        // drain the driver queue; nothing to react to headless
+      }
+      ecs.mouse = input.mouse;
+      for (const auto& ev : input.events) {
+        SDL_Event replayed = ev.to_sdl();
+        ecs.handle_event(replayed, state);
+      }
+      ecs.events.dispatch();
+      const uint64_t t_cleanup = SDL_GetTicksNS();
+
+      ecs.cleanup();
+      const uint64_t t_sim = SDL_GetTicksNS();
+
+      std::fill(system_ns.begin(), system_ns.end(), 0);
+      for (uint16_t tick = 0; tick < input.ticks; ++tick) {
+        sim.run(jobs);
+        ++state.frame_counter;
+        for (uint32_t i = 0; i < sim.size(); ++i) {
+          system_ns[i] += sim.last_ns(i);
+        }
+      }
+      const uint64_t t_render = SDL_GetTicksNS();
+
+      ecs.render();
+      const uint64_t t_present = SDL_GetTicksNS();
+      const uint64_t allocs_check = alloc_stats::count();
+
+      if (cfg.damage == damage_mode::check && !matches_full_redraw(renderer, ecs) && damage_mismatches++ == 0) {
+        first_damage_mismatch = frame;
+      }
+      const uint64_t check_ns = SDL_GetTicksNS() - t_present;  // left out of the timings and allocation counts
+      const uint64_t check_allocs = alloc_stats::count() - allocs_check;
+
+      SDL_RenderPresent(renderer);
+      const uint64_t t_end = SDL_GetTicksNS() - check_ns;
+      const uint64_t frame_allocs = alloc_stats::count() - allocs_start - check_allocs;
+
+      if (!cfg.replay.empty() && ecs.state_hash(state) != input.state_hash && mismatches++ == 0) {
+        first_mismatch = frame;
+      }
+
+      if (frame < cfg.warmup) {
+        manager.take_draw_calls();
+        continue;
+      }
+
+      uint32_t s = 0;
+      samples[s++].emplace_back(t_cleanup - t_events);
+      samples[s++].emplace_back(t_sim - t_cleanup);
+      for (const auto ns : system_ns) {
+        samples[s++].emplace_back(ns);
+      }
+      samples[s++].emplace_back(t_render - t_sim);
+      samples[s++].emplace_back(t_present - t_render);
+      samples[s++].emplace_back(t_end - t_present);
+      samples[s++].emplace_back(t_end - t_events);
+
+      draw_calls += manager.take_draw_calls();
+      allocs += frame_allocs;
+      max_frame_allocs = std::max(max_frame_allocs, frame_allocs);
+      if (cfg.max_allocs >= 0 && frame_allocs > static_cast<uint64_t>(cfg.max_allocs)) {
+        ++over_budget;
+      }
+      measured_ns += t_end - t_events;
+      ++measured;
+    }
+    ecs.jobs = nullptr;
+
+    if (!cfg.trace.empty()) {
+      profiler::dump_chrome_trace(cfg.trace.c_str(), measured);
+    }
+
+    std::FILE* out = nullptr;
+    if (rc != 0) {
+      // no scene, nothing ran
+    } else if (measured == 0) {
+      SDL_Log("No frames measured; the replay is shorter than --warmup\n");
+      rc = 6;
+    } else if (out = cfg.out.empty() ? stdout : std::fopen(cfg.out.c_str(), "w"); out == nullptr) {
+      SDL_Log("Unable to open %s\n", cfg.out.c_str());
+      rc = 5;
+    } else {
+      uint32_t entities = 0;
+      for (const auto& arch : ecs.archetypes) {
+        entities += arch.size();
+      }
+
+      std::fprintf(out, "{\n");
+      std::fprintf(out, "  \"scene\": {\"eyes\": %u, \"draggables\": %u, \"zones\": %u, \"entities\": %u, \"source\": \"%s\", \"setup_ms\": %.3f},\n",
+                   cfg.scene.crowd_eyes, cfg.scene.draggables, cfg.scene.zones, entities, cfg.scene_file.empty() ? "built" : cfg.scene_file.c_str(),
+                   setup_ns / 1e6);
+      std::fprintf(out, "  \"driver\": \"%s\",\n  \"renderer\": \"software\",\n  \"simd\": \"%s\",\n", cfg.driver.c_str(),
+                   simd::level_name(simd::kernels().lvl));
+      std::fprintf(out, "  \"workers\": %u,\n", jobs.size());
+      std::fprintf(out, "  \"frames\": %u,\n  \"warmup\": %u,\n", measured, cfg.warmup);
+      if (!cfg.replay.empty()) {
+        std::fprintf(out, "  \"replay\": \"%s\",\n  \"hash_mismatches\": %u,\n  \"first_mismatch_frame\": %d,\n", cfg.replay.c_str(), mismatches,
+                     mismatches != 0 ? static_cast<int>(first_mismatch) : -1);
+      }
+      std::fprintf(out, "  \"damage\": \"%s\",\n", cfg.damage == damage_mode::off ? "off" : cfg.damage == damage_mode::on ? "on" : "check");
+      if (cfg.damage == damage_mode::check) {
+        std::fprintf(out, "  \"damage_mismatches\": %u,\n  \"first_damage_mismatch_frame\": %d,\n", damage_mismatches,
+                     damage_mismatches != 0 ? static_cast<int>(first_damage_mismatch) : -1);
+      }
+      std::fprintf(out, "  \"fps\": %.2f,\n", measured * 1e9 / static_cast<double>(measured_ns));
+      std::fprintf(out, "  \"draw_calls_per_frame\": %.2f,\n  \"atlas_pages\": %zu,\n  \"prescaled_pages\": %zu,\n", static_cast<double>(draw_calls) / measured,
+                   manager.page_count(), manager.scaled_page_count());
+      std::fprintf(out, "  \"heap_allocs_per_frame\": {\"mean\": %.2f, \"max\": %llu},\n", static_cast<double>(allocs) / measured,
+                   static_cast<unsigned long long>(max_frame_allocs));
+      std::fprintf(out, "  \"timings_us\": {\n");
+      for (std::size_t s = 0; s < samples.size(); ++s) {
+        const auto sm = summarize(samples[s]);
+        std::fprintf(out, "    \"%s\": {\"p50\": %.3f, \"p99\": %.3f, \"max\": %.3f, \"mean\": %.3f}%s\n", stage_names[s], sm.p50_us, sm.p99_us, sm.max_us,
+                     sm.mean_us, s + 1 < samples.size() ? "," : "");
+      }
+      std::fprintf(out, "  }\n}\n");
+
+      if (out != stdout) {
+        std::fclose(out);
+      }
+    }
+
+    if (mismatches != 0) {
+      SDL_Log("replay diverged: %u frames with a different state hash, first at frame %u\n", mismatches, first_mismatch);
+      rc = 7;
+    }
+    if (over_budget != 0) {
+      SDL_Log("%u frames made more than %lld heap allocations (max %llu)\n", over_budget, static_cast<long long>(cfg.max_allocs),
+              static_cast<unsigned long long>(max_frame_allocs));
+      rc = 9;
+    }
+    if (damage_mismatches != 0) {
+      SDL_Log("damaged redraws differ from full redraws in %u frames, first at frame %u\n", damage_mismatches, first_damage_mismatch);
+      rc = 8;
+    }
+  }
+
+  SDL_DestroyRenderer(renderer);
+  SDL_DestroyWindow(window);
+  TTF_CloseFont(font);
+  SDL_Quit();
+  TTF_Quit();
+
+  return rc;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// center of object and object texture
+struct position {
+  float x;
+  float y;
+};
+
+// position at the start of the current sim tick; render blends from it toward position
+struct previous_position {
+  float x;
+  float y;
+};
+
+struct object_size {
+  float width;
+  float height;
+};
+
+struct texture_size {
+  float width;
+  float height;
+};
+
+struct motion {
+  float dx;
+  float dy;
+  float ax;
+  float ay;
+};
+
+struct drag {
+  float shift_x;
+  float shift_y;
+};
+
+struct mouse_tracker {
+  float anchor_x;
+  float anchor_y;
+  float target_x;
+  float target_y;
+  float max_radius;
+};
+
+// short string drawn from the glyph atlas into the entity's texture_size box
+struct text_label {
+  std::array<char, 15> chars;
+  uint8_t length;
+};
+
+// drawn layer by layer, then by order; static layers are composited once into a cached render target
+enum render_layer : uint8_t { kLayerBackground, kLayerWorld, kLayerForeground, kLayerUi, kLayerCount };
+inline constexpr std::array<bool, kLayerCount> kStaticLayer{true, false, true, false};
+
+struct drawable {
+  uint32_t texture_id;
+  uint32_t order;  // draw order within the layer, lower first
+  render_layer layer = kLayerWorld;
+};
+
+struct draggable {
+  bool is_dragged;
+};
+
+// *_event_id: game_event_id raised on the bus, or kNoEvent
+struct clickable {
+  bool is_pressed;
+  uint32_t press_event_id;
+  uint32_t release_event_id;
+  // pressed_texture_id
+};
+
+struct trigger_zone {
+  bool is_in_zone;
+  uint32_t enter_event_id;
+  uint32_t leave_event_id;
+  // triggered_texture_id
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Screen-space rectangles that changed this frame. Rectangles are merged when their union wastes little area, and
+// collapse into one bounding box past kMaxRects, since every rectangle costs a separate redraw pass.
+class damage_region {
+ public:
+  static constexpr uint32_t kMaxRects = 8;
+  static constexpr int kMergeSlack = 64 * 64;  // extra area a merge may add
+
+  damage_region(int width, int height) noexcept : width_{width}, height_{height} {}
+
+  void clear() noexcept { rects_.clear(); }
+
+  void add_all() noexcept {
+    rects_.assign(1, SDL_Rect{0, 0, width_, height_});
+  }
+
+  // covers the float rect, rounded outwards with a pixel of margin
+  void add(float x, float y, float w, float h) noexcept {
+    const int x0 = std::max(static_cast<int>(x) - 1, 0);
+    const int y0 = std::max(static_cast<int>(y) - 1, 0);
+    const int x1 = std::min(static_cast<int>(x + w) + 2, width_);
+    const int y1 = std::min(static_cast<int>(y + h) + 2, height_);
+    if (x1 <= x0 || y1 <= y0) {
+      return;
+    }
+
+    SDL_Rect r{x0, y0, x1 - x0, y1 - y0};
+    for (std::size_t i = 0; i < rects_.size();) {
+      if (const SDL_Rect u = unite(rects_[i], r); area(u) <= area(rects_[i]) + area(r) + kMergeSlack) {
+        r = u;
+        rects_[i] = rects_.back();
+        rects_.pop_back();
+        i = 0;  // the grown rect may now reach others
+      } else {
+        ++i;
+      }
+    }
+    rects_.emplace_back(r);
+
+    if (rects_.size() > kMaxRects) {
+      SDL_Rect all = rects_.front();
+      for (const auto& q : rects_) {
+        all = unite(all, q);
+      }
+      rects_.assign(1, all);
+    }
+  }
+
+  [[nodiscard]] bool empty() const noexcept { return rects_.empty(); }
+  [[nodiscard]] const std::vector<SDL_Rect>& rects() const noexcept { return rects_; }
+
+ private:
+  static int64_t area(const SDL_Rect& r) noexcept { return static_cast<int64_t>(r.w) * r.h; }
+
+  static SDL_Rect unite(const SDL_Rect& a, const SDL_Rect& b) noexcept {
+    const int x0 = std::min(a.x, b.x), y0 = std::min(a.y, b.y);
+    const int x1 = std::max(a.x + a.w, b.x + b.w), y1 = std::max(a.y + a.h, b.y + b.h);
+    return {x0, y0, x1 - x0, y1 - y0};
+  }
+
+  int width_;
+  int height_;
+  std::vector<SDL_Rect> rects_;
+};
@@ -1,12 +1,31 @@
 #pragma once
 
+#include "archetype.hpp"
+#include "damage.hpp"
+#include "entity.hpp"
+#include "event_bus.hpp"
 #include "globals.hpp"
+#include "input.hpp"
+#include "job_system.hpp"
+#include "log.hpp"
+#include "profiler.hpp"
+#include "scheduler.hpp"
+#include "simd.hpp"
+#include "spatial_grid.hpp"
 #include "texture.hpp"
+#include "view.hpp"
 
 #include "SDL3_ttf/SDL_ttf.h"
 
-#include <iomanip>
-#include <sstream>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
 
 namespace {
 uint64_t lcg32(uint64_t counter) {
@@ -24,439 +43,967 @@ struct game_state {
   uint64_t idle_start;
 
   bool is_eyes_closed = false;
-  uint16_t head_id;
-  uint16_t head_texture_next;
-  uint16_t next_blink_frame = 0;
+  entity head_id;
+  uint32_t head_texture_next;
+  uint64_t next_blink_frame = 0;
   uint64_t eyes_closed_start;
-};
 
-// entity
-// TODO: OOD data base design; handler_id needs only primary key! or handler is a bitmask
-struct handler_id {
-  uint16_t position_id;  // position id is unique key for handler
-  uint16_t obj_size_id;
-  uint16_t texture_id;
-  uint16_t tex_size_id;
-  uint16_t motion_id;
-  uint16_t drag_id;
-  uint16_t tracker_id;
+  entity score_id;
 };
 
-// center of object and object texture
-struct position {
-  float x;
-  float y;
-};
+struct ECS {
+  static constexpr uint32_t kNoId = std::numeric_limits<uint32_t>::max();
 
-struct object_size {
-  float width;
-  float height;
-};
+  SDL_Renderer* renderer;
+  TTF_Font* font;
+  texture_manager& manager;
 
-struct texture_size {
-  float width;
-  float height;
-};
+  static constexpr uint32_t kInteractionReserve = 64;
 
-struct motion {
-  float dx;
-  float dy;
-  float ax;
-  float ay;
-};
+  ECS(SDL_Renderer* r, TTF_Font* f, texture_manager& m) : renderer(r), font(f), manager(m) {
+    for (auto* v : {&dragged, &pressed, &entered, &to_delete}) {
+      v->reserve(kInteractionReserve);
+    }
+  }
 
-struct drag {
-  float shift_x;
-  float shift_y;
-};
+  // entity -> (archetype, row)
+  struct entity_record {
+    uint32_t archetype;
+    uint32_t row;
+    uint16_t generation;
+  };
+
+  std::vector<entity_record> records;
+  std::vector<uint32_t> free_indices;
+
+  // tables
+  std::vector<archetype> archetypes;
+  std::unordered_map<component_mask, uint32_t> archetype_by_mask;
+
+  // render scratch, reused between frames
+  struct draw_command {
+    render_layer layer;
+    uint32_t order;
+    uint32_t texture_id;
+    float x;
+    float y;
+    float width;
+    float height;
+    uint32_t seq;  // glyph index within a label; 0 for sprites
+  };
+  std::span<draw_command> draw_list;  // in frame_memory
+  uint32_t next_draw_order = 0;
+
+  // transient per-frame data; the caller resets it at the top of every frame
+  frame_arena frame_memory;
+
+  // composited static layers; rebuilt when their draw commands change
+  struct layer_cache {
+    texture target;
+    SDL_FRect bounds{};
+    uint64_t signature = 0;
+    bool valid = false;
+  };
+  std::array<layer_cache, kLayerCount> layer_caches;
+
+  // Redraw only what changed since the last frame. Meant for the software renderer, where fill rate is the frame
+  // cost; the frame is kept in a target texture because the backbuffer is not preserved across presents.
+  bool damage_tracking = false;
+  damage_region damage{kScreenWidth, kScreenHeight};
+  std::vector<draw_command> last_draw_list;
+  texture frame_target;
+  bool frame_valid = false;
+
+  // hit testing over position + object_size
+  spatial_grid grid;
+
+  // interaction state, so input only touches what is engaged
+  std::vector<entity> dragged;
+  std::vector<entity> pressed;
+  std::vector<entity> entered;
 
-struct mouse_tracker {
-  float anchor_x;
-  float anchor_y;
-  float target_x;
-  float target_y;
-  float max_radius;
-};
+  // to delete
+  std::vector<entity> to_delete;
 
-struct movable {
-  uint16_t position_id;
-  uint16_t motion_id;
-};
+  // optional; lets par_chunks split big tables across threads
+  job_system* jobs = nullptr;
 
-struct drawable {
-  uint16_t position_id;
-  uint16_t texture_id;
-  uint16_t tex_size_id;
-};
+  // game timers, in sim ticks
+  static constexpr uint64_t kIdleLookPeriod = kSimHz * 5;  // unattended eyes glance around this often
+  static constexpr uint64_t kIdleLookTicks = kSimHz;
+  static constexpr uint64_t kEyesClosedTicks = std::max<uint64_t>(1, kSimHz / 6);  // at least a tick, or the eyes never close
 
-struct draggable {
-  uint16_t position_id;
-  uint16_t obj_size_id;
-  uint16_t drag_id;
-  bool is_dragged;
-};
+  // Optional adaptive sub-stepping for plain motion (trackers are stepped exactly either way); for low tick rates
+  static constexpr float kMaxStepDistance = 4.f;  // px
+  static constexpr uint32_t kMaxSubsteps = 8;
+  bool substep_motion = kSimHz < 60;
 
-struct mouse_trackable {
-  uint16_t position_id;
-  uint16_t tracker_id;
-  uint16_t motion_id;
-};
+  // below this (px/s, px/s^2) a moving thing counts as at rest
+  static constexpr float kSettledEpsilon = 1e-2f;
 
-struct clickable {
-  uint16_t position_id;
-  uint16_t obj_size_id;
-  bool is_pressed;
-  // press_event_id
-  uint16_t release_event_id;
-  // pressed_texture_id
-};
+  // gameplay reactions; input emits, handlers run in dispatch() after input processing
+  event_bus events;
 
-struct trigger_zone {
-  uint16_t position_id;
-  uint16_t obj_size_id;
-  bool is_in_zone;
-  // enter_event_id
-  // leave_event_id
-  // triggered_texture_id
-};
+  // this frame's mouse, set by the caller from live input or a replay; systems never ask SDL directly
+  mouse_state mouse;
 
-// TODO: Try OOD table method to arrange data
-struct ECS {
-  static constexpr uint16_t kNoId = std::numeric_limits<uint16_t>::max();
+  // what the last tick saw: input handled since then, and the point the trackers chased. Until a tick has seen the
+  // newest of both, the game is not idle.
+  bool input_since_tick = false;
+  simd::track_target last_target{.x = -1.f, .y = -1.f, .to_anchor = false};
 
-  SDL_Renderer* renderer;
-  TTF_Font* font;
-  texture_manager& manager;
+  // Call at the top of every frame: recycles the frame arena (and with it the last draw list).
+  void begin_frame() {
+    draw_list = {};
+    frame_memory.reset();
+  }
 
-  ECS(SDL_Renderer* r, TTF_Font* f, texture_manager& m) : renderer(r), font(f), manager(m) {}
+  // Preallocates `rows` more entities holding Cs (on top of position and previous_position), so a scene of known size
+  // is built without growing tables mid-game.
+  template <typename... Cs>
+  void reserve(uint32_t rows) {
+    const auto arch_idx = find_or_create_archetype(components::mask<position, previous_position, Cs...>());
+    archetypes[arch_idx].reserve(archetypes[arch_idx].size() + rows);
+    records.reserve(records.size() + rows);
+    free_indices.reserve(records.capacity());
+  }
 
-  // components
-  std::vector<position> positions;
-  std::vector<object_size> object_sizes;
+  // register entity
+  entity register_object(float x, float y) noexcept {
+    uint32_t idx;
+    if (!free_indices.empty()) {
+      idx = free_indices.back();
+      free_indices.pop_back();
+    } else if (records.size() < entity::kMaxEntities) [[likely]] {
+      idx = static_cast<uint32_t>(records.size());
+      records.emplace_back(kNoId, kNoId, 0);
+    } else {
+      LOG_WARN("entity limit %u reached\n", entity::kMaxEntities);
+      return entity::null();
+    }
 
-  std::vector<texture_size> texture_sizes;
+    const entity e = entity::make(idx, records[idx].generation);
+    const auto arch_idx = find_or_create_archetype(components::mask<position, previous_position>());
+    auto& arch = archetypes[arch_idx];
+    records[idx].archetype = arch_idx;
+    records[idx].row = arch.size();
+    arch.entities.emplace_back(e);
+    arch.column<position>().emplace_back(x, y);
+    arch.column<previous_position>().emplace_back(x, y);
 
-  std::vector<motion> motions;
-  std::vector<drag> drags;
-  std::vector<mouse_tracker> trackers;
+    return e;
+  }
 
-  // handlers
-  std::vector<handler_id> handlers;
+  // drops every entity at once; tables, chunks and grid cells keep their storage for the next scene
+  void clear() noexcept {
+    records.clear();
+    free_indices.clear();
+    for (auto& arch : archetypes) {
+      arch.clear();
+    }
+    grid.clear();
+    dragged.clear();
+    pressed.clear();
+    entered.clear();
+    to_delete.clear();
+    next_draw_order = 0;
+    last_draw_list.clear();
+    invalidate_layers();
+  }
 
-  // systems (component links)
-  std::vector<movable> movs;
-  std::vector<drawable> draws;
-  std::vector<draggable> draggs;
-  std::vector<mouse_trackable> tracks;
-  std::vector<clickable> buttons;
-  std::vector<trigger_zone> zones;
+  [[nodiscard]] bool is_alive(entity e) const noexcept {
+    return e.index() < records.size() && records[e.index()].generation == e.generation() && records[e.index()].archetype != kNoId;
+  }
 
-  // to delete
-  std::vector<uint16_t> to_delete;
+  // stale handles are ignored
+  void destroy_entity(entity e) noexcept {
+    if (is_alive(e)) {
+      to_delete.emplace_back(e);
+    }
+  }
 
-  // register entity
-  handler_id register_object(float x, float y) noexcept {
-    handler_id h{.position_id = static_cast<uint16_t>(positions.size()),
-                 .obj_size_id = kNoId,
-                 .texture_id = kNoId,
-                 .tex_size_id = kNoId,
-                 .motion_id = kNoId,
-                 .drag_id = kNoId,
-                 .tracker_id = kNoId};
-    positions.emplace_back(x, y);
-    handlers.emplace_back(h);
+  void cleanup() noexcept {
+    PROFILE_ZONE("ECS::cleanup");
 
-    return h;
-  }
+    for (const auto e : to_delete) {
+      if (!is_alive(e)) {
+        continue;  // already deleted
+      }
+      LOG_DEBUG("deleting entt %u (gen %u)\n", e.index(), e.generation());
 
-  void destroy_entity(const handler_id& h) noexcept { to_delete.emplace_back(h.position_id); }
-  void destroy_entity(uint16_t position_id) noexcept { to_delete.emplace_back(position_id); }
+      grid.remove(e);
 
-  void cleanup() noexcept {
-    for (const auto pos_id : to_delete) {
-      SDL_Log("deleting entt %d\n", pos_id);
-      std::erase_if(handlers, [&](const handler_id& h) { return h.position_id == pos_id; });
+      auto& rec = records[e.index()];
+      if (const auto moved = archetypes[rec.archetype].remove_row(rec.row); !moved.is_null()) {
+        records[moved.index()].row = rec.row;
+      }
 
-      std::erase_if(draggs, [&](const draggable& sys) { return sys.position_id == pos_id; });
-      std::erase_if(draws, [&](const drawable& sys) { return sys.position_id == pos_id; });
-      std::erase_if(tracks, [&](const mouse_trackable& sys) { return sys.position_id == pos_id; });
+      rec.archetype = kNoId;
+      rec.row = kNoId;
+      rec.generation = (rec.generation + 1) & entity::kGenerationMask;
+      free_indices.emplace_back(e.index());
     }
 
     to_delete.clear();
   }
 
-  // attach component
-  void add_tracker(handler_id& handler, float x, float y, float r) noexcept {
-    handler.tracker_id = trackers.size();
-    trackers.emplace_back(x, y, x, y, r);
+  template <typename C>
+  [[nodiscard]] C* try_get(entity e) noexcept {
+    if (!is_alive(e)) {
+      return nullptr;
+    }
+    const auto& rec = records[e.index()];
+    auto& arch = archetypes[rec.archetype];
+    return arch.has(components::bit<C>()) ? &arch.column<C>()[rec.row] : nullptr;
+  }
+
+  // attach components; migrates the entity to the matching table in amortized O(1)
+  template <typename... Cs>
+  void add_components(entity e, Cs&&... values) noexcept {
+    if (!is_alive(e)) {
+      return;
+    }
+
+    auto& rec = records[e.index()];
+    const auto src_idx = rec.archetype;
+    const auto src_mask = archetypes[src_idx].mask;
+    const auto dst_mask = src_mask | components::mask<std::remove_cvref_t<Cs>...>();
+
+    if (dst_mask != src_mask) {
+      const auto dst_idx = find_or_create_archetype(dst_mask);
+      auto& src = archetypes[src_idx];
+      auto& dst = archetypes[dst_idx];
+
+      components::for_each([&]<typename C>() {
+        if (dst.mask & components::bit<C>()) {
+          if (src.mask & components::bit<C>()) {
+            dst.template column<C>().emplace_back(std::move(src.template column<C>()[rec.row]));
+          } else {
+            dst.template column<C>().emplace_back();
+          }
+        }
+      });
+      dst.entities.emplace_back(e);
 
-    make_movable(handler);
+      if (const auto moved = src.remove_row(rec.row); !moved.is_null()) {
+        records[moved.index()].row = rec.row;
+      }
 
-    tracks.emplace_back(handler.position_id, handler.tracker_id, handler.motion_id);
+      rec.archetype = dst_idx;
+      rec.row = dst.size() - 1;
+    }
+
+    auto& arch = archetypes[rec.archetype];
+    ((arch.column<std::remove_cvref_t<Cs>>()[rec.row] = std::forward<Cs>(values)), ...);
   }
 
-  void add_dimetions(handler_id& handler, float w, float h) noexcept {
-    handler.obj_size_id = object_sizes.size();
-    object_sizes.emplace_back(w, h);
+  uint32_t find_or_create_archetype(component_mask mask) noexcept {
+    if (auto it = archetype_by_mask.find(mask); it != archetype_by_mask.end()) {
+      return it->second;
+    }
+
+    archetypes.emplace_back().mask = mask;
+    const auto idx = static_cast<uint32_t>(archetypes.size() - 1);
+    archetype_by_mask.emplace(mask, idx);
+    return idx;
   }
 
-  void add_drag(handler_id& h) noexcept {
-    h.drag_id = drags.size();
-    drags.emplace_back(0.f, 0.f);
+  void add_tracker(entity e, float x, float y, float r) noexcept { add_components(e, mouse_tracker{x, y, x, y, r}, motion{0.f, 0.f, 0.f, 0.f}); }
+
+  void add_dimetions(entity e, float w, float h) noexcept {
+    add_components(e, object_size{w, h});
+
+    if (const auto* pos = try_get<position>(e); pos != nullptr) {
+      grid.insert(e, aabb::from(*pos, {w, h}));
+    }
   }
 
-  void add_texture(handler_id& handler, uint16_t texture_id) noexcept {
+  void add_drag(entity e) noexcept { add_components(e, drag{0.f, 0.f}); }
+
+  void add_texture(entity e, uint32_t texture_id) noexcept {
     auto [w, h] = manager.get_texture_sizes(texture_id);
 
-    add_texture(handler, texture_id, w, h);
+    add_texture(e, texture_id, w, h);
   }
 
-  void add_texture(handler_id& handler, uint16_t texture_id, float w, float h) noexcept {
-    handler.texture_id = texture_id;
-    handler.tex_size_id = texture_sizes.size();
+  void add_texture(entity e, uint32_t texture_id, float w, float h) noexcept {
+    add_components(e, texture_size{w, h}, drawable{texture_id, next_draw_order++});
+  }
 
-    texture_sizes.emplace_back(w, h);
-    draws.emplace_back(handler.position_id, handler.texture_id, handler.tex_size_id);
+  // text drawn from the glyph atlas, stretched to w x h
+  void add_text(entity e, std::string_view text, float w, float h) noexcept {
+    add_components(e, texture_size{w, h}, drawable{texture_manager::kNoImage, next_draw_order++}, text_label{});
+    set_text(e, text);
   }
 
-  void make_draggable(handler_id& h) noexcept { draggs.emplace_back(h.position_id, h.obj_size_id, h.drag_id, false); }
-  void make_clickable(handler_id& h) noexcept { buttons.emplace_back(h.position_id, h.obj_size_id, false, 0); }
-  void make_triggerable(handler_id& h) noexcept { zones.emplace_back(h.position_id, h.obj_size_id, false); }
-  void make_movable(handler_id& h) noexcept {
-    h.motion_id = motions.size();
-    motions.emplace_back(0.f, 0.f, 0.f, 0.f);
+  void set_layer(entity e, render_layer layer) noexcept {
+    if (auto* dr = try_get<drawable>(e); dr != nullptr) {
+      dr->layer = layer;
+    }
+  }
 
-    movs.emplace_back(h.position_id, h.motion_id);
+  // render targets are lost on device resets
+  void invalidate_layers() noexcept {
+    for (auto& cache : layer_caches) {
+      cache.valid = false;
+    }
+    frame_valid = false;
+  }
+
+  // after a device reset: the pre-scaled copies live in render targets too
+  void reset_render_targets() noexcept {
+    manager.drop_scaled();
+    invalidate_layers();
+  }
+
+  void set_text(entity e, std::string_view text) noexcept {
+    if (auto* label = try_get<text_label>(e); label != nullptr) {
+      label->length = static_cast<uint8_t>(text.copy(label->chars.data(), label->chars.size()));
+    }
+  }
+
+  void make_draggable(entity e) noexcept { add_components(e, draggable{false}); }
+  void make_clickable(entity e, uint32_t release_event = kEventBlink, uint32_t press_event = kNoEvent) noexcept {
+    add_components(e, clickable{false, press_event, release_event});
+  }
+  void make_triggerable(entity e, uint32_t enter_event = kNoEvent, uint32_t leave_event = kNoEvent) noexcept {
+    add_components(e, trigger_zone{false, enter_event, leave_event});
+  }
+  void make_movable(entity e) noexcept { add_components(e, motion{0.f, 0.f, 0.f, 0.f}); }
+
+  // every entity holding at least Cs; const Cs are read-only
+  template <typename... Cs>
+  [[nodiscard]] component_view<Cs...> view() noexcept {
+    return {archetypes, jobs};
+  }
+
+  // tick systems and what they touch; the scheduler runs the non-conflicting ones side by side
+  void register_systems(scheduler& sim, game_state& state) {
+    sim.add<reads<position>, writes<previous_position>>("store_previous", [this] { store_previous(); });
+    sim.add<reads<drag, object_size>, writes<position, spatial_grid>>("move_dragged", [this] { move_dragged(); });
+    sim.add<reads<>, writes<position, motion, mouse_tracker, game_state>>("move_tracked", [this, &state] { move_tracked(state); });
+    sim.add<reads<>, writes<drawable, game_state>>("loop_logic", [this, &state] { loop_logic(state); });
+    sim.add<reads<object_size>, writes<position, motion, spatial_grid>>("move", [this] { move(); });
   }
 
   // logic
   void move_dragged() noexcept {
-    float x = -1.f, y = -1.f;
-    SDL_GetMouseState(&x, &y);
+    PROFILE_ZONE("ECS::move_dragged");
+
+    const float x = mouse.x, y = mouse.y;
+
+    for (const auto e : dragged) {
+      auto* pos = try_get<position>(e);
+      const auto* dr = try_get<drag>(e);
+      if (pos == nullptr || dr == nullptr) {
+        continue;
+      }
 
-    for (const auto& sys : draggs) {
-      if (sys.is_dragged) {
-        auto& pos = positions[sys.position_id];
-        const auto& dr = drags[sys.drag_id];
+      pos->x = x + dr->shift_x;
+      pos->y = y + dr->shift_y;
 
-        pos.x = x + dr.shift_x;
-        pos.y = y + dr.shift_y;
+      if (const auto* dim = try_get<object_size>(e); dim != nullptr) {
+        grid.update(e, aabb::from(*pos, *dim));
       }
     }
   }
 
+  // once per sim tick, before anything moves
+  void store_previous() noexcept {
+    PROFILE_ZONE("ECS::store_previous");
+
+    view<const position, previous_position>().par_chunks([](uint32_t n, const position* p, previous_position* q) {
+      for (uint32_t i = 0; i < n; ++i) {
+        q[i] = {p[i].x, p[i].y};
+      }
+    });
+  }
+
   void move_tracked(game_state& state) noexcept {
-    static constexpr float stiffness = 400.0f;
-    static constexpr float damping = 15.0f;
+    PROFILE_ZONE("ECS::move_tracked");
 
-    float x_target, y_target;
+    static constexpr simd::spring spring{.stiffness = 400.0f, .damping = 15.0f, .depth = 300.0f};
+    static const simd::spring_step step = simd::make_step(spring, kTickDt);
 
-    if (state.frame_counter % (60 * 5) == 0) {
+    if (state.frame_counter % kIdleLookPeriod == 0) {
       state.is_eyes_idle = true;
       state.idle_start = state.frame_counter;
     }
 
-    if (state.is_eyes_idle == true && (state.frame_counter - state.idle_start == 60)) {
+    if (state.is_eyes_idle == true && (state.frame_counter - state.idle_start == kIdleLookTicks)) {
       state.is_eyes_idle = false;
     }
 
-    for (const auto sys : tracks) {
-      auto& pos = positions[sys.position_id];
-      auto& anc = trackers[sys.tracker_id];
-      auto& vel = motions[sys.motion_id];
+    const simd::track_target target = track_target(state);
+    last_target = target;
+    input_since_tick = false;
 
-      if (state.is_eyes_idle) {
-        float x = -1.f, y = -1.f;
-        if (state.frame_counter - state.idle_start < 30) {
-          anc.target_x = 200;
-          anc.target_y = 300;
-        } else {
-          anc.target_x = 600;
-          anc.target_y = 300;
-        }
-      } else {
-        if (SDL_GetMouseFocus() == nullptr) {
-          anc.target_x = anc.anchor_x;
-          anc.target_y = anc.anchor_y;
-        } else {
-          SDL_GetMouseState(&anc.target_x, &anc.target_y);
-        }
-      }
-
-      const float x_anc = static_cast<float>(anc.anchor_x);
-      const float y_anc = static_cast<float>(anc.anchor_y);
-
-      float x_vec = anc.target_x - x_anc;
-      float y_vec = anc.target_y - y_anc;
-      const float z_vec = 300;
+    const auto track = simd::kernels().track;
+    view<position, motion, mouse_tracker>().par_chunks(
+        [&](uint32_t n, position* pos, motion* vel, mouse_tracker* anc) { track(pos, vel, anc, n, target, spring, step); });
+  }
 
-      float norm = std::sqrt(x_vec * x_vec + y_vec * y_vec + z_vec * z_vec);
+  // every tracker chases the same point this tick
+  [[nodiscard]] simd::track_target track_target(const game_state& state) const noexcept {
+    simd::track_target target{.x = -1.f, .y = -1.f, .to_anchor = false};
+    if (state.is_eyes_idle) {
+      target.x = state.frame_counter - state.idle_start < kIdleLookTicks / 2 ? 200 : 600;
+      target.y = 300;
+    } else if (!mouse.focused) {
+      target.to_anchor = true;
+    } else {
+      target.x = mouse.x;
+      target.y = mouse.y;
+    }
+    return target;
+  }
 
-      x_vec /= norm;
-      y_vec /= norm;
+  void blink_head(game_state& state) noexcept {
+    if (auto* dr = try_get<drawable>(state.head_id); dr != nullptr) {
+      std::swap(dr->texture_id, state.head_texture_next);
+    }
+  }
 
-      x_target = anc.max_radius * x_vec + x_anc;
-      y_target = anc.max_radius * y_vec + y_anc;
+  // closes the eyes for a few ticks and schedules the next idle blink
+  void close_eyes(game_state& state) noexcept {
+    state.is_eyes_closed = true;
+    state.eyes_closed_start = state.frame_counter;
 
-      float target_dx = x_target - pos.x;
-      float target_dy = y_target - pos.y;
+    blink_head(state);
 
-      vel.ax = stiffness * target_dx - damping * vel.dx;
-      vel.ay = stiffness * target_dy - damping * vel.dy;
-    }
+    uint32_t delay = kSimHz + lcg32(state.frame_counter) % (2 * kSimHz);
+    state.next_blink_frame = state.frame_counter + delay;
   }
 
   void loop_logic(game_state& state) noexcept {
+    PROFILE_ZONE("ECS::loop_logic");
+
     if (state.frame_counter >= state.next_blink_frame) {
-      state.is_eyes_closed = true;
-      state.eyes_closed_start = state.frame_counter;
+      close_eyes(state);
+    }
 
-      auto it = std::find_if(draws.begin(), draws.end(), [&](auto& dr) { return dr.position_id == state.head_id; });
-      if (it != draws.end()) {
-        std::swap(it->texture_id, state.head_texture_next);
-      }
+    if (state.is_eyes_closed && (state.frame_counter - state.eyes_closed_start >= kEyesClosedTicks)) {
+      state.is_eyes_closed = false;
 
-      uint32_t delay = 60 + lcg32(state.frame_counter) % 120;
-      state.next_blink_frame = state.frame_counter + delay;
+      blink_head(state);
     }
+  }
 
-    if (state.is_eyes_closed && (state.frame_counter - state.eyes_closed_start >= 10)) {
-      state.is_eyes_closed = false;
+  // How many upcoming ticks would change nothing but frame_counter: everything has come to rest, nothing is queued, no
+  // input is waiting on a tick and the next timer (blink, eyes reopening, idle glance) is that far off. 0 while
+  // anything is still going on.
+  [[nodiscard]] uint64_t idle_ticks(const game_state& state) noexcept {
+    if (!to_delete.empty() || events.pending() != 0 || input_since_tick || !dragged.empty()) {
+      return 0;
+    }
+    if (const auto target = track_target(state);
+        target.to_anchor != last_target.to_anchor || (!target.to_anchor && (target.x != last_target.x || target.y != last_target.y))) {
+      return 0;  // the trackers have not seen where the mouse went
+    }
 
-      auto it = std::find_if(draws.begin(), draws.end(), [&](auto& dr) { return dr.position_id == state.head_id; });
-      if (it != draws.end()) {
-        std::swap(it->texture_id, state.head_texture_next);
-      }
+    const uint64_t now = state.frame_counter;
+    uint64_t due = std::min(state.next_blink_frame, (now + kIdleLookPeriod - 1) / kIdleLookPeriod * kIdleLookPeriod);
+    if (state.is_eyes_closed) {
+      due = std::min(due, state.eyes_closed_start + kEyesClosedTicks);
+    }
+    if (state.is_eyes_idle) {
+      due = std::min(due, state.idle_start + (now - state.idle_start < kIdleLookTicks / 2 ? kIdleLookTicks / 2 : kIdleLookTicks));
+    }
+    if (due <= now) {
+      return 0;
     }
+
+    bool settled = true;
+    view<const motion>().chunks([&](uint32_t n, const motion* vel) {
+      for (uint32_t i = 0; settled && i < n; ++i) {
+        settled = std::abs(vel[i].dx) < kSettledEpsilon && std::abs(vel[i].dy) < kSettledEpsilon && std::abs(vel[i].ax) < kSettledEpsilon &&
+                  std::abs(vel[i].ay) < kSettledEpsilon;
+      }
+    });
+    return settled ? due - now : 0;
+  }
+
+  // exact box test for a grid candidate
+  [[nodiscard]] bool hit(entity e, float x, float y) noexcept {
+    const auto* pos = try_get<position>(e);
+    const auto* dim = try_get<object_size>(e);
+    return pos != nullptr && dim != nullptr && aabb::from(*pos, *dim).contains(x, y);
   }
 
   void handle_event(SDL_Event& e, game_state& state) noexcept {
-    float x = -1.f, y = -1.f;
-    SDL_GetMouseState(&x, &y);
+    PROFILE_ZONE("ECS::handle_event");
+
+    input_since_tick = true;
+
+    const float x = mouse.x, y = mouse.y;
+    const bool left_down = (mouse.buttons & SDL_BUTTON_MASK(SDL_BUTTON_LEFT)) != 0;
 
     if (e.type == SDL_EVENT_MOUSE_MOTION) {
       // mouse might leave button
-      for (auto& click_sys : buttons) {
-        if (click_sys.is_pressed) [[unlikely]] {
-          const auto& dim = object_sizes[click_sys.obj_size_id];
-          const auto& pos = positions[click_sys.position_id];
-
-          if (pos.x - dim.width / 2 > x || x > pos.x + dim.width / 2 || pos.y - dim.height / 2 > y || y > pos.y + dim.height / 2) {
-            SDL_Log("Mouse left button %d scope; won't trigger event\n", click_sys.position_id);
-            click_sys.is_pressed = false;
-            // no event trigger
-          }
+      std::erase_if(pressed, [&](entity b) {
+        auto* click = try_get<clickable>(b);
+        if (click == nullptr) {
+          return true;
         }
-      }
-
-      // mouse might enter or leave zone
-      for (auto& zone_sys : zones) {
-        const auto& dim = object_sizes[zone_sys.obj_size_id];
-        const auto& pos = positions[zone_sys.position_id];
-
-        const bool is_now_in_zone = (pos.x - dim.width / 2 <= x && x <= pos.x + dim.width / 2 && pos.y - dim.height / 2 <= y && y <= pos.y + dim.height / 2);
-        if (is_now_in_zone ^ zone_sys.is_in_zone) {
-          if (zone_sys.is_in_zone) {
-            SDL_Log("Zone %d is left; trigger leave event\n", zone_sys.position_id);
-          } else {
-            SDL_Log("Zone %d is entered; trigger enter event\n", zone_sys.position_id);
-          }
-          zone_sys.is_in_zone = !zone_sys.is_in_zone;
+        if (!hit(b, x, y)) {
+          LOG_DEBUG("Mouse left button %u scope; won't trigger event\n", b.index());
+          click->is_pressed = false;
+          // no event trigger
+          return true;
         }
-      }
+        return false;
+      });
+
+      // mouse might leave zone
+      std::erase_if(entered, [&](entity z) {
+        auto* zone = try_get<trigger_zone>(z);
+        if (zone == nullptr) {
+          return true;
+        }
+        if (!hit(z, x, y)) {
+          LOG_DEBUG("Zone %u is left; trigger leave event\n", z.index());
+          zone->is_in_zone = false;
+          events.emit(zone->leave_event_id, z);
+          return true;
+        }
+        return false;
+      });
+
+      // or enter one
+      grid.query(x, y, [&](entity z) {
+        if (auto* zone = try_get<trigger_zone>(z); zone != nullptr && !zone->is_in_zone && hit(z, x, y)) {
+          LOG_DEBUG("Zone %u is entered; trigger enter event\n", z.index());
+          zone->is_in_zone = true;
+          events.emit(zone->enter_event_id, z);
+          entered.emplace_back(z);
+        }
+      });
     }
 
-    else if (e.type == SDL_EVENT_MOUSE_BUTTON_DOWN && (SDL_GetMouseState(nullptr, nullptr) & SDL_BUTTON_MASK(SDL_BUTTON_LEFT))) {
+    else if (e.type == SDL_EVENT_MOUSE_BUTTON_DOWN && left_down) {
       state.score++;
-      std::ostringstream oss;
-      oss << std::setw(6) << std::setfill('0') << state.score;
-      std::string new_str = oss.str();
-      manager.update_texture_from_text_named(renderer, font, new_str, "score", 0x00, 0x00, 0x00, 0xFF);
-
-      // someone can be dragged!
-      for (auto& drag_sys : draggs) {
-        auto& dr = drags[drag_sys.drag_id];
-        const auto& dim = object_sizes[drag_sys.obj_size_id];
-        const auto& pos = positions[drag_sys.position_id];
-
-        if (pos.x - dim.width / 2 <= x && x <= pos.x + dim.width / 2 && pos.y - dim.height / 2 <= y && y <= pos.y + dim.height / 2) {
-          drag_sys.is_dragged = true;
-
-          dr.shift_x = pos.x - x;
-          dr.shift_y = pos.y - y;
+      char score_str[16];
+      const int len = std::snprintf(score_str, sizeof(score_str), "%06u", state.score);
+      set_text(state.score_id, {score_str, static_cast<std::size_t>(len)});
+
+      grid.query(x, y, [&](entity c) {
+        if (!hit(c, x, y)) {
+          return;
         }
-      }
 
-      // or clicked!
-      for (auto& click_sys : buttons) {
-        const auto& dim = object_sizes[click_sys.obj_size_id];
-        const auto& pos = positions[click_sys.position_id];
+        // someone can be dragged!
+        auto* dg = try_get<draggable>(c);
+        auto* dr = try_get<drag>(c);
+        if (dg != nullptr && dr != nullptr && !dg->is_dragged) {
+          const auto* pos = try_get<position>(c);
+          dg->is_dragged = true;
+          dragged.emplace_back(c);
 
-        if (pos.x - dim.width / 2 <= x && x <= pos.x + dim.width / 2 && pos.y - dim.height / 2 <= y && y <= pos.y + dim.height / 2) {
-          SDL_Log("button %d is pressed; trigger press event\n", click_sys.position_id);
-          click_sys.is_pressed = true;
+          dr->shift_x = pos->x - x;
+          dr->shift_y = pos->y - y;
         }
-      }
+
+        // or clicked!
+        if (auto* click = try_get<clickable>(c); click != nullptr && !click->is_pressed) {
+          LOG_DEBUG("button %u is pressed; trigger press event\n", c.index());
+          click->is_pressed = true;
+          pressed.emplace_back(c);
+          events.emit(click->press_event_id, c);
+        }
+      });
     }
 
-    else if (e.type == SDL_EVENT_MOUSE_BUTTON_UP && !(SDL_GetMouseState(nullptr, nullptr) & SDL_BUTTON_MASK(SDL_BUTTON_LEFT))) {
+    else if (e.type == SDL_EVENT_MOUSE_BUTTON_UP && !left_down) {
       // nobody is dragged!
-      for (auto& drag_sys : draggs) {
-        if (drag_sys.is_dragged == true) {
-          SDL_Log("marking entt %d for delete\n", drag_sys.position_id);
-          destroy_entity(drag_sys.position_id);
+      for (const auto d : dragged) {
+        if (auto* dg = try_get<draggable>(d); dg != nullptr) {
+          LOG_DEBUG("marking entt %u for delete\n", d.index());
+          destroy_entity(d);
+          dg->is_dragged = false;
         }
-        drag_sys.is_dragged = false;
       }
+      dragged.clear();
 
       // button may be released
-      for (auto& click_sys : buttons) {
-        const auto& dim = object_sizes[click_sys.obj_size_id];
-        const auto& pos = positions[click_sys.position_id];
-
-        if (pos.x - dim.width / 2 <= x && x <= pos.x + dim.width / 2 && pos.y - dim.height / 2 <= y && y <= pos.y + dim.height / 2) {
-          if (click_sys.is_pressed == true) {
-            click_sys.is_pressed = false;
-            SDL_Log("button %d is released; trigger release event\n", click_sys.position_id);
-            // trigger some event
-            if (click_sys.release_event_id == 0 && !state.is_eyes_closed) {
-              state.is_eyes_closed = true;
-              state.eyes_closed_start = state.frame_counter;
-
-              auto it = std::find_if(draws.begin(), draws.end(), [&](auto& dr) { return dr.position_id == state.head_id; });
-              if (it != draws.end()) {
-                std::swap(it->texture_id, state.head_texture_next);
-              }
-
-              uint32_t delay = 60 + lcg32(state.frame_counter) % 120;
-              state.next_blink_frame = state.frame_counter + delay;
-            }
+      std::erase_if(pressed, [&](entity b) {
+        auto* click = try_get<clickable>(b);
+        if (click == nullptr) {
+          return true;
+        }
+        if (!hit(b, x, y)) {
+          return false;
+        }
+
+        click->is_pressed = false;
+        LOG_DEBUG("button %u is released; trigger release event\n", b.index());
+        events.emit(click->release_event_id, b);
+        return true;
+      });
+    }
+  }
+
+  // FNV-1a over everything the simulation decides; replays compare it frame by frame
+  [[nodiscard]] uint64_t state_hash(const game_state& state) const noexcept {
+    uint64_t h = 0xcbf29ce484222325ull;
+    auto add = [&](uint64_t v) {
+      for (int i = 0; i < 8; ++i) {
+        h = (h ^ ((v >> (i * 8)) & 0xFF)) * 0x100000001b3ull;
+      }
+    };
+    auto add_float = [&](float f) { add(std::bit_cast<uint32_t>(f)); };
+
+    add(state.frame_counter);
+    add(state.score);
+    add(state.is_eyes_idle);
+    add(state.is_eyes_closed);
+    add(state.next_blink_frame);
+    add(state.head_texture_next);
+
+    for (const auto& arch : archetypes) {
+      if (arch.size() == 0) {
+        continue;
+      }
+
+      add(arch.mask);
+      for (uint32_t i = 0; i < arch.size(); ++i) {
+        add(arch.entities[i].value);
+      }
+
+      if (arch.has(components::bit<position>())) {
+        for (const auto& p : arch.column<position>()) {
+          add_float(p.x);
+          add_float(p.y);
+        }
+      }
+      if (arch.has(components::bit<motion>())) {
+        for (const auto& m : arch.column<motion>()) {
+          add_float(m.dx);
+          add_float(m.dy);
+        }
+      }
+      if (arch.has(components::bit<drawable>())) {
+        for (const auto& d : arch.column<drawable>()) {
+          add(d.texture_id);
+        }
+      }
+      if (arch.has(components::bit<text_label>())) {
+        for (const auto& t : arch.column<text_label>()) {
+          for (uint8_t c = 0; c < t.length; ++c) {
+            add(static_cast<uint8_t>(t.chars[c]));
           }
         }
       }
+      if (arch.has(components::bit<draggable>())) {
+        for (const auto& d : arch.column<draggable>()) {
+          add(d.is_dragged);
+        }
+      }
+      if (arch.has(components::bit<clickable>())) {
+        for (const auto& c : arch.column<clickable>()) {
+          add(c.is_pressed);
+        }
+      }
+      if (arch.has(components::bit<trigger_zone>())) {
+        for (const auto& z : arch.column<trigger_zone>()) {
+          add(z.is_in_zone);
+        }
+      }
     }
+    return h;
   }
 
-  void render() noexcept {
-    for (auto dr : draws) {
-      const auto& pos = positions[dr.position_id];
-      const auto& dim = texture_sizes[dr.tex_size_id];
+  // alpha: how far the frame is between the previous sim tick (0) and the latest one (1)
+  void render(float alpha = 1.f) noexcept {
+    PROFILE_ZONE("ECS::render");
 
-      manager.render(renderer, dr.texture_id, pos.x, pos.y, dim.width, dim.height);
+    // copies first used last frame; layers cached before drew those quads resampled
+    if (manager.build_scaled(renderer) != 0) {
+      invalidate_layers();
+    }
+
+    // labels draw as their glyphs only; a sprite command of their own would share the first glyph's draw key
+    const auto sprites = view<const position, const previous_position, const texture_size, const drawable>().without<text_label>();
+    const auto labels = view<const position, const previous_position, const texture_size, const drawable, const text_label>();
+
+    // a label lays out at most one glyph per char
+    std::size_t capacity = sprites.size();
+    labels.each([&](const position&, const previous_position&, const texture_size&, const drawable&, const text_label& label) { capacity += label.length; });
+    auto* commands = frame_memory.make_array<draw_command>(capacity);
+    std::size_t count = 0;
+
+    sprites.chunks([&](uint32_t n, const position* pos, const previous_position* prev, const texture_size* dim, const drawable* dr) {
+      for (uint32_t i = 0; i < n; ++i) {
+        commands[count++] = {dr[i].layer, dr[i].order, dr[i].texture_id, std::lerp(prev[i].x, pos[i].x, alpha), std::lerp(prev[i].y, pos[i].y, alpha),
+                             dim[i].width, dim[i].height, 0u};
+      }
+    });
+
+    labels.each([&](const position& pos, const previous_position& prev, const texture_size& dim, const drawable& dr, const text_label& label) {
+      uint32_t seq = 0;
+      manager.layout_text({label.chars.data(), label.length}, std::lerp(prev.x, pos.x, alpha), std::lerp(prev.y, pos.y, alpha), dim.width, dim.height,
+                          [&](uint32_t tex_id, float x, float y, float w, float h) { commands[count++] = {dr.layer, dr.order, tex_id, x, y, w, h, seq++}; });
+    });
+
+    draw_list = {commands, count};
+
+    // tables interleave draw order; restore it
+    std::sort(draw_list.begin(), draw_list.end(), [](const draw_command& a, const draw_command& b) { return draw_key(a) < draw_key(b); });
+
+    if (damage_tracking) {
+      render_damaged();
+    } else {
+      render_full();
     }
   }
 
-  void move() noexcept {
-    static constexpr float dt = 1.0 / kScreenFps;
-    for (auto mv : movs) {
-      auto& pos = positions[mv.position_id];
-      auto& vel = motions[mv.motion_id];
+  // draws the current draw list in full, into whatever target is set
+  void render_full() noexcept {
+    draw_layers(nullptr);
+    manager.flush(renderer);
+  }
+
+  // render_full from the draw list alone: no layer caches and no pre-scaled copies, so a stale one cannot match itself
+  void render_reference() noexcept {
+    manager.pause_scaled(true);
+    draw_layers(nullptr, false);
+    manager.flush(renderer);
+    manager.pause_scaled(false);
+  }
 
-      vel.dx += vel.ax * dt;
-      vel.dy += vel.ay * dt;
+  using draw_iterator = const draw_command*;
 
-      pos.x += vel.dx * dt;
-      pos.y += vel.dy * dt;
+  static std::tuple<uint8_t, uint32_t, uint32_t> draw_key(const draw_command& cmd) noexcept { return {cmd.layer, cmd.order, cmd.seq}; }
+
+  static SDL_FRect draw_rect(const draw_command& cmd) noexcept { return {cmd.x - cmd.width / 2, cmd.y - cmd.height / 2, cmd.width, cmd.height}; }
+
+  // clip: when set, the caller has clipped rendering to it and commands outside it are skipped
+  void draw_layers(const SDL_Rect* clip, bool use_caches = true) noexcept {
+    draw_iterator first = draw_list.data();
+    const draw_iterator end = first + draw_list.size();
+    for (uint8_t layer = 0; layer < kLayerCount; ++layer) {
+      const draw_iterator last = std::find_if(first, end, [&](const draw_command& cmd) { return cmd.layer != layer; });
+      if (!use_caches || !kStaticLayer[layer] || !draw_static_layer(static_cast<render_layer>(layer), first, last, clip)) {
+        draw_direct(static_cast<render_layer>(layer), first, last, clip);
+      }
+      first = last;
     }
   }
+
+  static bool outside(const SDL_FRect& r, const SDL_Rect* clip) noexcept {
+    if (clip == nullptr) {
+      return false;
+    }
+    const SDL_FRect c{static_cast<float>(clip->x), static_cast<float>(clip->y), static_cast<float>(clip->w), static_cast<float>(clip->h)};
+    return !SDL_HasRectIntersectionFloat(&r, &c);
+  }
+
+  void draw_direct(render_layer layer, draw_iterator first, draw_iterator last, const SDL_Rect* clip) noexcept {
+    if (layer == kLayerBackground) {
+      SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+      if (clip != nullptr) {
+        // RenderClear ignores the clip rect
+        const SDL_FRect c{static_cast<float>(clip->x), static_cast<float>(clip->y), static_cast<float>(clip->w), static_cast<float>(clip->h)};
+        SDL_RenderFillRect(renderer, &c);
+      } else {
+        SDL_RenderClear(renderer);
+      }
+    }
+    for (auto it = first; it != last; ++it) {
+      if (!outside(draw_rect(*it), clip)) {
+        manager.batch(renderer, it->texture_id, it->x, it->y, it->width, it->height);
+      }
+    }
+  }
+
+  // Diffs the draw list against the last frame's and redraws, clipped, the rects where they differ: moved, swapped
+  // or retextured sprites (score glyphs included) damage both where they were and where they are now.
+  void render_damaged() noexcept {
+    PROFILE_ZONE("ECS::render_damaged");
+
+    if (!make_frame_target()) {
+      render_full();
+      return;
+    }
+
+    find_damage();
+    last_draw_list.assign(draw_list.begin(), draw_list.end());
+    frame_valid = true;
+
+    if (!damage.empty()) {
+      manager.flush(renderer);
+      SDL_SetRenderTarget(renderer, frame_target.ptr());
+      for (const auto& r : damage.rects()) {
+        SDL_SetRenderClipRect(renderer, &r);
+        draw_layers(&r);
+        manager.flush(renderer);
+      }
+      SDL_SetRenderClipRect(renderer, nullptr);
+      SDL_SetRenderTarget(renderer, nullptr);
+    }
+
+    manager.draw_texture(renderer, frame_target.ptr(), {0.f, 0.f, static_cast<float>(kScreenWidth), static_cast<float>(kScreenHeight)});
+  }
+
+  bool make_frame_target() noexcept {
+    if (frame_target.ptr() != nullptr) {
+      return true;
+    }
+
+    SDL_Texture* target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, kScreenWidth, kScreenHeight);
+    if (target == nullptr) {
+      LOG_ERROR("Unable to create frame target, redrawing in full! SDL error: %s\n", SDL_GetError());
+      damage_tracking = false;
+      return false;
+    }
+    SDL_SetTextureBlendMode(target, SDL_BLENDMODE_NONE);
+    SDL_SetTextureScaleMode(target, SDL_SCALEMODE_NEAREST);
+    frame_target = texture(target);
+    frame_valid = false;
+    return true;
+  }
+
+  // both lists are sorted by draw_key, so one merge pass pairs up each command with its last-frame self
+  void find_damage() noexcept {
+    damage.clear();
+    if (!frame_valid) {
+      damage.add_all();
+      return;
+    }
+
+    const auto add = [&](const draw_command& cmd) {
+      const SDL_FRect r = draw_rect(cmd);
+      damage.add(r.x, r.y, r.w, r.h);
+    };
+
+    auto a = last_draw_list.cbegin();
+    auto b = draw_list.begin();
+    while (a != last_draw_list.cend() || b != draw_list.end()) {
+      if (b == draw_list.end() || (a != last_draw_list.cend() && draw_key(*a) < draw_key(*b))) {
+        add(*a++);  // gone
+      } else if (a == last_draw_list.cend() || draw_key(*b) < draw_key(*a)) {
+        add(*b++);  // new
+      } else {
+        if (a->texture_id != b->texture_id || a->x != b->x || a->y != b->y || a->width != b->width || a->height != b->height) {
+          add(*a);
+          add(*b);
+        }
+        ++a;
+        ++b;
+      }
+    }
+  }
+
+  // one quad from the layer's cache; false if no cache could be made
+  bool draw_static_layer(render_layer layer, draw_iterator first, draw_iterator last, const SDL_Rect* clip) noexcept {
+    uint64_t signature = 0xcbf29ce484222325ull;
+    for (auto it = first; it != last; ++it) {
+      for (const uint32_t v : {it->texture_id, std::bit_cast<uint32_t>(it->x), std::bit_cast<uint32_t>(it->y), std::bit_cast<uint32_t>(it->width),
+                               std::bit_cast<uint32_t>(it->height)}) {
+        signature = (signature ^ v) * 0x100000001b3ull;
+      }
+    }
+
+    auto& cache = layer_caches[layer];
+    if ((!cache.valid || cache.signature != signature) && !compose_layer(layer, cache, first, last)) {
+      return false;
+    }
+    cache.signature = signature;
+
+    if (cache.bounds.w > 0.f && cache.bounds.h > 0.f && !outside(cache.bounds, clip)) {
+      manager.draw_texture(renderer, cache.target.ptr(), cache.bounds);
+    }
+    return true;
+  }
+
+  // The background is opaque and full-screen, so it also stands in for the frame clear. Other static layers cover
+  // just their sprites and are kept premultiplied, which is what blending into a transparent target produces.
+  bool compose_layer(render_layer layer, layer_cache& cache, draw_iterator first, draw_iterator last) noexcept {
+    const bool opaque = layer == kLayerBackground;
+
+    SDL_FRect bounds{0.f, 0.f, static_cast<float>(kScreenWidth), static_cast<float>(kScreenHeight)};
+    if (!opaque) {
+      float x0 = bounds.w, y0 = bounds.h, x1 = 0.f, y1 = 0.f;
+      for (auto it = first; it != last; ++it) {
+        x0 = std::min(x0, it->x - it->width / 2);
+        y0 = std::min(y0, it->y - it->height / 2);
+        x1 = std::max(x1, it->x + it->width / 2);
+        y1 = std::max(y1, it->y + it->height / 2);
+      }
+      x0 = std::max(std::floor(x0), 0.f);
+      y0 = std::max(std::floor(y0), 0.f);
+      x1 = std::min(std::ceil(x1), bounds.w);
+      y1 = std::min(std::ceil(y1), bounds.h);
+      bounds = {x0, y0, std::max(x1 - x0, 0.f), std::max(y1 - y0, 0.f)};
+    }
+
+    cache.valid = true;
+    cache.bounds = bounds;
+    if (bounds.w == 0.f || bounds.h == 0.f) {
+      return true;  // nothing on screen
+    }
+
+    float tex_w = 0.f, tex_h = 0.f;
+    if (cache.target.ptr() != nullptr) {
+      SDL_GetTextureSize(cache.target.ptr(), &tex_w, &tex_h);
+    }
+    if (tex_w != bounds.w || tex_h != bounds.h) {
+      SDL_Texture* target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, static_cast<int>(bounds.w),
+                                              static_cast<int>(bounds.h));
+      if (target == nullptr) {
+        LOG_ERROR("Unable to create layer cache! SDL error: %s\n", SDL_GetError());
+        cache.valid = false;
+        return false;
+      }
+      SDL_SetTextureScaleMode(target, SDL_SCALEMODE_NEAREST);
+      cache.target = texture(target);
+    }
+    SDL_SetTextureBlendMode(cache.target.ptr(), opaque ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+
+    // composing can happen mid-frame, while drawing into the frame target
+    manager.flush(renderer);
+    SDL_Texture* previous = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, cache.target.ptr());
+    if (opaque) {
+      SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+    } else {
+      SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0x00);
+    }
+    SDL_RenderClear(renderer);
+
+    for (auto it = first; it != last; ++it) {
+      manager.batch(renderer, it->texture_id, it->x - bounds.x, it->y - bounds.y, it->width, it->height);
+    }
+    manager.flush(renderer);
+    SDL_SetRenderTarget(renderer, previous);
+
+    return true;
+  }
+
+  // Sub-steps a chunk needs so that nothing in it travels more than kMaxStepDistance per step. Explicit integration
+  // error grows with the step, so fast movers get finer steps while slow chunks keep one.
+  static uint32_t substeps(const motion* vel, uint32_t n) noexcept {
+    float speed = 0.f;
+    for (uint32_t i = 0; i < n; ++i) {
+      speed = std::max(speed, std::abs(vel[i].dx) + std::abs(vel[i].dy) + (std::abs(vel[i].ax) + std::abs(vel[i].ay)) * kTickDt);
+    }
+    const float steps = std::ceil(speed * kTickDt / kMaxStepDistance);
+    return static_cast<uint32_t>(std::clamp(steps, 1.f, static_cast<float>(kMaxSubsteps)));
+  }
+
+  void move() noexcept {
+    PROFILE_ZONE("ECS::move");
+
+    const auto integrate = simd::kernels().integrate;
+    // trackers were stepped exactly in move_tracked
+    view<position, motion>().without<mouse_tracker>().par_chunks([&](uint32_t n, position* pos, motion* vel) {
+      const uint32_t steps = substep_motion ? substeps(vel, n) : 1;
+      for (uint32_t s = 0; s < steps; ++s) {
+        integrate(pos, vel, n, kTickDt / steps);
+      }
+    });
+
+    // keep moving hit boxes indexed
+    view<const position, const motion, const object_size>().each_entity(
+        [&](entity e, const position& pos, const motion&, const object_size& dim) { grid.update(e, aabb::from(pos, dim)); });
+  }
 };
\ No newline at end of file
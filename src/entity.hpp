@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+// generational entity handle: low 20 bits index, high 12 bits generation
+struct entity {
+  static constexpr uint32_t kIndexBits = 20;
+  static constexpr uint32_t kIndexMask = (1u << kIndexBits) - 1;
+  static constexpr uint32_t kGenerationMask = std::numeric_limits<uint32_t>::max() >> kIndexBits;
+  static constexpr uint32_t kMaxEntities = kIndexMask;  // index kIndexMask is reserved for null
+
+  uint32_t value = std::numeric_limits<uint32_t>::max();
+
+  static constexpr entity make(uint32_t index, uint32_t generation) noexcept { return {(index & kIndexMask) | ((generation & kGenerationMask) << kIndexBits)}; }
+  static constexpr entity null() noexcept { return {}; }
+
+  [[nodiscard]] constexpr uint32_t index() const noexcept { return value & kIndexMask; }
+  [[nodiscard]] constexpr uint32_t generation() const noexcept { return value >> kIndexBits; }
+  [[nodiscard]] constexpr bool is_null() const noexcept { return index() == kIndexMask; }
+
+  constexpr bool operator==(const entity&) const noexcept = default;
+};
+
+static_assert(sizeof(entity) == sizeof(uint32_t));
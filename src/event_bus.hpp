@@ -0,0 +1,68 @@
+#pragma once
+
+#include "entity.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+// gameplay event ids; clickable and trigger_zone store the ones they raise
+enum game_event_id : uint32_t {
+  kEventBlink = 0,  // the head closes its eyes
+  kEventCount,
+};
+
+inline constexpr uint32_t kNoEvent = std::numeric_limits<uint32_t>::max();
+
+struct game_event {
+  uint32_t id;
+  entity source;
+};
+
+// Per-frame event queue. Input handling emits into a preallocated queue; dispatch() then runs it once, finding each
+// event's handlers in a table indexed by id. Emit and dispatch on the main thread only.
+class event_bus {
+ public:
+  using handler = std::function<void(const game_event&)>;
+
+  static constexpr uint32_t kQueueCapacity = 256;
+
+  event_bus() {
+    queue_.reserve(kQueueCapacity);
+    handlers_.resize(kEventCount);
+  }
+
+  // ids past kEventCount grow the table; do not subscribe from inside a handler
+  void subscribe(uint32_t id, handler h) {
+    if (id >= handlers_.size()) {
+      handlers_.resize(id + 1);
+    }
+    handlers_[id].emplace_back(std::move(h));
+  }
+
+  void emit(uint32_t id, entity source) noexcept {
+    if (id != kNoEvent) {
+      queue_.emplace_back(id, source);
+    }
+  }
+
+  // events emitted by handlers run in the same pass
+  void dispatch() noexcept {
+    for (std::size_t i = 0; i < queue_.size(); ++i) {
+      const game_event ev = queue_[i];  // a handler may emit and reallocate the queue
+      if (ev.id < handlers_.size()) {
+        for (const auto& h : handlers_[ev.id]) {
+          h(ev);
+        }
+      }
+    }
+    queue_.clear();
+  }
+
+  [[nodiscard]] std::size_t pending() const noexcept { return queue_.size(); }
+
+ private:
+  std::vector<game_event> queue_;
+  std::vector<std::vector<handler>> handlers_;  // by event id
+};
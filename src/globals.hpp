@@ -6,4 +6,13 @@ constexpr uint64_t kScreenWidth{800};
 constexpr uint64_t kScreenHeight{600};
 
 constexpr uint64_t kScreenFps{60};
-constexpr uint64_t kNsPerFrame = 1'000'000'000 / kScreenFps;
\ No newline at end of file
+constexpr uint64_t kNsPerFrame = 1'000'000'000 / kScreenFps;
+
+// simulation steps at a fixed rate whatever the render rate; frame_counter counts these ticks. Frames interpolate
+// between ticks, so weak machines can build with -DAEOM_SIM_HZ=20 or 30 and keep rendering smoothly.
+#ifndef AEOM_SIM_HZ
+#define AEOM_SIM_HZ 60
+#endif
+constexpr uint64_t kSimHz{AEOM_SIM_HZ};
+constexpr uint64_t kNsPerTick = 1'000'000'000 / kSimHz;
+constexpr float kTickDt = 1.0 / kSimHz;
\ No newline at end of file
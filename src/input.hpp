@@ -0,0 +1,64 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <cstdint>
+
+// mouse as the game sees it for one frame: sampled once after the frame's events are pumped
+struct mouse_state {
+  float x = -1.f;
+  float y = -1.f;
+  SDL_MouseButtonFlags buttons = 0;
+  bool focused = false;
+};
+
+inline mouse_state read_mouse() noexcept {
+  mouse_state m;
+  m.buttons = SDL_GetMouseState(&m.x, &m.y);
+  m.focused = SDL_GetMouseFocus() != nullptr;
+  return m;
+}
+
+// the part of an SDL event ECS::handle_event looks at
+struct input_event {
+  enum kind : uint8_t { kMotion, kButtonDown, kButtonUp };
+
+  kind type;
+  uint8_t button;
+
+  // false for events the game does not react to
+  static bool from_sdl(const SDL_Event& e, input_event& out) noexcept {
+    switch (e.type) {
+      case SDL_EVENT_MOUSE_MOTION:
+        out = {kMotion, 0};
+        return true;
+      case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        out = {kButtonDown, e.button.button};
+        return true;
+      case SDL_EVENT_MOUSE_BUTTON_UP:
+        out = {kButtonUp, e.button.button};
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  SDL_Event to_sdl() const noexcept {
+    SDL_Event e{};
+    switch (type) {
+      case kMotion:
+        e.type = SDL_EVENT_MOUSE_MOTION;
+        break;
+      case kButtonDown:
+        e.type = SDL_EVENT_MOUSE_BUTTON_DOWN;
+        e.button.button = button;
+        e.button.down = true;
+        break;
+      case kButtonUp:
+        e.type = SDL_EVENT_MOUSE_BUTTON_UP;
+        e.button.button = button;
+        break;
+    }
+    return e;
+  }
+};
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool. Every worker owns a deque: it pushes and pops its own jobs LIFO and steals from the
+// front of the others when it runs dry. Threads that are not workers submit into a shared inbox and, while waiting,
+// run jobs themselves instead of blocking.
+class job_system {
+ public:
+  job_system() : job_system(default_workers()) {}
+
+  explicit job_system(uint32_t workers) : queues_(workers + 1) {
+    for (auto& q : queues_) {
+      q = std::make_unique<work_queue>();
+    }
+
+    threads_.reserve(workers);
+    for (uint32_t i = 0; i < workers; ++i) {
+      threads_.emplace_back([this, i] { run(i); });
+    }
+  }
+
+  job_system(const job_system&) = delete;
+  job_system& operator=(const job_system&) = delete;
+
+  // finishes queued jobs, then joins
+  ~job_system() {
+    {
+      std::lock_guard lock{sleep_mutex_};
+      stop_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto& t : threads_) {
+      t.join();
+    }
+  }
+
+  static uint32_t default_workers() noexcept { return static_cast<uint32_t>(std::max(1, SDL_GetNumLogicalCPUCores() - 1)); }
+
+  [[nodiscard]] uint32_t size() const noexcept { return static_cast<uint32_t>(threads_.size()); }
+
+  void submit(std::function<void()> job) {
+    auto& q = *queues_[local_queue()];
+    {
+      std::lock_guard lock{q.mutex};
+      q.jobs.push_back(std::move(job));
+    }
+
+    queued_.fetch_add(1, std::memory_order_release);
+    {
+      std::lock_guard lock{sleep_mutex_};  // orders the count against a worker about to sleep
+    }
+    wake_.notify_one();
+  }
+
+  // runs other jobs until done() holds
+  template <typename Done>
+  void wait_until(Done&& done) noexcept {
+    while (!done()) {
+      if (!run_one(local_queue())) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  // f(begin, end) over [0, count) in grain-sized ranges; the caller takes the first range and helps with the rest
+  template <typename F>
+  void parallel_for(uint32_t count, uint32_t grain, F&& f) noexcept {
+    if (count <= grain || threads_.empty()) {
+      for (uint32_t begin = 0; begin < count; begin += grain) {
+        f(begin, std::min(begin + grain, count));
+      }
+      return;
+    }
+
+    // jobs capture one pointer and an index, small enough for std::function to store without allocating
+    struct ranges {
+      F& f;
+      uint32_t count;
+      uint32_t grain;
+      std::atomic<uint32_t> left;
+    } r{f, count, grain, (count - 1) / grain};
+
+    for (uint32_t begin = grain; begin < count; begin += grain) {
+      submit([r = &r, begin] {
+        r->f(begin, std::min(begin + r->grain, r->count));
+        r->left.fetch_sub(1, std::memory_order_release);
+      });
+    }
+
+    f(0u, grain);
+    wait_until([&] { return r.left.load(std::memory_order_acquire) == 0; });
+  }
+
+ private:
+  // double-ended ring; grows by doubling and never shrinks, so a warmed-up queue stops allocating
+  class job_ring {
+   public:
+    [[nodiscard]] bool empty() const noexcept { return head_ == tail_; }
+
+    void push_back(std::function<void()>&& job) {
+      if (tail_ - head_ == slots_.size()) {
+        grow();
+      }
+      slots_[tail_++ & (slots_.size() - 1)] = std::move(job);
+    }
+
+    std::function<void()> pop_back() noexcept { return std::move(slots_[--tail_ & (slots_.size() - 1)]); }
+    std::function<void()> pop_front() noexcept { return std::move(slots_[head_++ & (slots_.size() - 1)]); }
+
+   private:
+    void grow() {
+      std::vector<std::function<void()>> bigger(std::max<std::size_t>(slots_.size() * 2, 64));
+      for (auto i = head_; i < tail_; ++i) {
+        bigger[i - head_] = std::move(slots_[i & (slots_.size() - 1)]);
+      }
+      tail_ -= head_;
+      head_ = 0;
+      slots_ = std::move(bigger);
+    }
+
+    std::vector<std::function<void()>> slots_;
+    uint64_t head_ = 0;
+    uint64_t tail_ = 0;
+  };
+
+  struct work_queue {
+    std::mutex mutex;
+    job_ring jobs;
+  };
+
+  // workers own queues_[0..size()); everyone else shares the last one
+  uint32_t local_queue() const noexcept { return current_owner == this ? current_index : size(); }
+
+  bool run_one(uint32_t own) noexcept {
+    std::function<void()> job;
+    if (!pop_back(own, job)) {
+      for (uint32_t i = 1; i < queues_.size() && !job; ++i) {
+        steal_front((own + i) % queues_.size(), job);
+      }
+    }
+    if (!job) {
+      return false;
+    }
+
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    job();
+    return true;
+  }
+
+  bool pop_back(uint32_t idx, std::function<void()>& out) noexcept {
+    auto& q = *queues_[idx];
+    std::lock_guard lock{q.mutex};
+    if (q.jobs.empty()) {
+      return false;
+    }
+    out = q.jobs.pop_back();
+    return true;
+  }
+
+  bool steal_front(uint32_t idx, std::function<void()>& out) noexcept {
+    auto& q = *queues_[idx];
+    std::lock_guard lock{q.mutex};
+    if (q.jobs.empty()) {
+      return false;
+    }
+    out = q.jobs.pop_front();
+    return true;
+  }
+
+  void run(uint32_t idx) noexcept {
+    current_owner = this;
+    current_index = idx;
+
+    for (;;) {
+      if (run_one(idx)) {
+        continue;
+      }
+
+      std::unique_lock lock{sleep_mutex_};
+      if (stop_ && queued_.load(std::memory_order_acquire) == 0) {
+        return;
+      }
+      wake_.wait(lock, [&] { return stop_ || queued_.load(std::memory_order_acquire) != 0; });
+    }
+  }
+
+  static inline thread_local const job_system* current_owner = nullptr;
+  static inline thread_local uint32_t current_index = 0;
+
+  std::vector<std::unique_ptr<work_queue>> queues_;
+  std::atomic<uint32_t> queued_{0};  // jobs pushed and not yet taken
+
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  bool stop_ = false;  // guarded by sleep_mutex_
+
+  std::vector<std::thread> threads_;  // last, so the queues exist before any worker starts
+};
@@ -0,0 +1,339 @@
+#pragma once
+
+// Asynchronous logging. LOG_DEBUG/LOG_INFO/LOG_WARN/LOG_ERROR copy the format pointer and their arguments into a
+// binary record on a lock-free ring; a background thread formats the records and hands them to SDL_Log, so the
+// calling thread never waits on the terminal. Levels below AEOM_LOG_LEVEL (0 debug .. 3 error; cmake
+// -DAEOM_LOG_LEVEL=N, by default debug in debug builds and info otherwise) compile to nothing, arguments included.
+//
+// The format must be a string literal; %s arguments are copied, so temporaries such as SDL_GetError() are fine.
+// Records that do not fit the ring are dropped and counted rather than blocking the caller.
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+#ifndef AEOM_LOG_LEVEL
+#ifdef NDEBUG
+#define AEOM_LOG_LEVEL 1
+#else
+#define AEOM_LOG_LEVEL 0
+#endif
+#endif
+
+namespace logging {
+
+enum level : uint8_t { kDebug, kInfo, kWarn, kError };
+
+inline constexpr int kMinLevel = AEOM_LOG_LEVEL;
+
+// one log call: format, level and the arguments, each a tag byte followed by its value
+struct record {
+  static constexpr std::size_t kPayload = 232;
+
+  const char* format;
+  level lvl;
+  uint8_t count;  // arguments stored; fewer than the format asks for when the payload ran out
+  uint16_t size;
+  std::byte payload[kPayload];
+};
+
+enum arg_tag : uint8_t { kSigned, kUnsigned, kFloat, kString, kPointer };
+
+class encoder {
+ public:
+  explicit encoder(record& r) noexcept : r_{r} {
+    r_.count = 0;
+    r_.size = 0;
+  }
+
+  template <typename T>
+  void add(const T& v) noexcept {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_array_v<T>) {
+      add_string(v);
+    } else if constexpr (std::is_same_v<U, char*> || std::is_same_v<U, const char*>) {
+      add_string(v != nullptr ? v : "(null)");
+    } else if constexpr (std::is_pointer_v<U>) {
+      put(kPointer, reinterpret_cast<uintptr_t>(v));
+    } else if constexpr (std::is_floating_point_v<U>) {
+      put(kFloat, static_cast<double>(v));
+    } else if constexpr (std::is_enum_v<U>) {
+      add(static_cast<std::underlying_type_t<U>>(v));
+    } else if constexpr (std::is_signed_v<U>) {
+      put(kSigned, static_cast<int64_t>(v));
+    } else {
+      static_assert(std::is_integral_v<U>, "unsupported log argument");
+      put(kUnsigned, static_cast<uint64_t>(v));
+    }
+  }
+
+ private:
+  template <typename V>
+  void put(arg_tag tag, V v) noexcept {
+    if (full_ || r_.size + 1 + sizeof(V) > record::kPayload) {
+      full_ = true;
+      return;
+    }
+    r_.payload[r_.size] = static_cast<std::byte>(tag);
+    std::memcpy(r_.payload + r_.size + 1, &v, sizeof(V));
+    r_.size += 1 + sizeof(V);
+    ++r_.count;
+  }
+
+  // truncated to what is left of the payload
+  void add_string(const char* s) noexcept {
+    if (full_ || r_.size + 2u > record::kPayload) {
+      full_ = true;
+      return;
+    }
+    const auto length = static_cast<uint8_t>(std::min({std::strlen(s), record::kPayload - r_.size - 2, std::size_t{255}}));
+    r_.payload[r_.size] = static_cast<std::byte>(kString);
+    r_.payload[r_.size + 1] = static_cast<std::byte>(length);
+    std::memcpy(r_.payload + r_.size + 2, s, length);
+    r_.size += 2 + length;
+    ++r_.count;
+  }
+
+  record& r_;
+  bool full_ = false;
+};
+
+// printf over a decoded record; each conversion is handed to snprintf on its own with the stored value
+inline void format(const record& r, char* out, std::size_t capacity) noexcept {
+  std::size_t n = 0;
+  std::size_t at = 0;
+  uint8_t left = r.count;
+
+  auto emit = [&](int written) {
+    if (written > 0) {
+      n = std::min(n + static_cast<std::size_t>(written), capacity - 1);
+    }
+  };
+
+  for (const char* f = r.format; *f != '\0' && n + 1 < capacity;) {
+    if (*f != '%') {
+      out[n++] = *f++;
+      continue;
+    }
+    if (f[1] == '%') {
+      out[n++] = '%';
+      f += 2;
+      continue;
+    }
+
+    // flags, width and precision are kept; length modifiers are replaced to match the stored type
+    char spec[32] = "%";
+    std::size_t s = 1;
+    for (++f; *f != '\0' && std::strchr("-+ #0123456789.", *f) != nullptr && s < sizeof(spec) - 4; ++f) {
+      spec[s++] = *f;
+    }
+    while (*f != '\0' && std::strchr("hljztL", *f) != nullptr) {
+      ++f;
+    }
+    const char conv = *f;
+    if (conv == '\0') {
+      break;
+    }
+    ++f;
+
+    if (left == 0) {
+      emit(std::snprintf(out + n, capacity - n, "<?>"));
+      continue;
+    }
+    --left;
+
+    const auto tag = static_cast<arg_tag>(r.payload[at]);
+    uint64_t bits = 0;
+    const char* str = "";
+    uint8_t length = 0;
+    if (tag == kString) {
+      length = static_cast<uint8_t>(r.payload[at + 1]);
+      str = reinterpret_cast<const char*>(r.payload + at + 2);
+      at += 2 + length;
+    } else {
+      std::memcpy(&bits, r.payload + at + 1, sizeof(bits));
+      at += 1 + sizeof(bits);
+    }
+
+    // spec + suffix, e.g. "%06" + "llu"
+    const auto with = [&](const char* suffix) {
+      std::strcat(spec, suffix);
+      return spec;
+    };
+    const char conv_suffix[] = {'l', 'l', conv, '\0'};
+
+    switch (conv) {
+      case 'd':
+      case 'i':
+        emit(std::snprintf(out + n, capacity - n, with("lld"), static_cast<long long>(bits)));
+        break;
+      case 'u':
+      case 'x':
+      case 'X':
+      case 'o':
+        emit(std::snprintf(out + n, capacity - n, with(conv_suffix), static_cast<unsigned long long>(bits)));
+        break;
+      case 'c':
+        emit(std::snprintf(out + n, capacity - n, with("c"), static_cast<int>(bits)));
+        break;
+      case 's':
+        emit(tag == kString ? std::snprintf(out + n, capacity - n, with(".*s"), static_cast<int>(length), str) : std::snprintf(out + n, capacity - n, "<?>"));
+        break;
+      case 'p':
+        emit(std::snprintf(out + n, capacity - n, "%p", reinterpret_cast<void*>(static_cast<uintptr_t>(bits))));
+        break;
+      default: {  // f e g a and their capitals
+        const double v = tag == kFloat    ? std::bit_cast<double>(bits)
+                         : tag == kSigned ? static_cast<double>(static_cast<int64_t>(bits))
+                                          : static_cast<double>(bits);
+        const char suffix[] = {conv, '\0'};
+        emit(std::snprintf(out + n, capacity - n, with(suffix), v));
+        break;
+      }
+    }
+  }
+  out[n] = '\0';
+}
+
+// Bounded multi-producer ring (per-slot sequence numbers) drained by one thread. pending_ counts published records;
+// the writer thread sleeps on it while it is zero, so producers only pay for a wake after a quiet spell.
+class sink {
+ public:
+  static constexpr uint32_t kCapacity = 1024;
+
+  sink() : slots_{std::make_unique<slot[]>(kCapacity)} {
+    for (uint32_t i = 0; i < kCapacity; ++i) {
+      slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+    writer_ = std::thread([this] { drain(); });
+  }
+
+  sink(const sink&) = delete;
+  sink& operator=(const sink&) = delete;
+
+  // writes out everything still queued
+  ~sink() {
+    pending_.fetch_or(kStopBit, std::memory_order_release);
+    pending_.notify_one();
+    writer_.join();
+  }
+
+  static sink& get() {
+    static sink s;
+    return s;
+  }
+
+  template <typename... Args>
+  void push(level lvl, const char* format, const Args&... args) noexcept {
+    uint64_t pos = tail_.load(std::memory_order_relaxed);
+    slot* sl;
+    for (;;) {
+      sl = &slots_[pos & (kCapacity - 1)];
+      const auto diff = static_cast<int64_t>(sl->seq.load(std::memory_order_acquire) - pos);
+      if (diff == 0 && tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+      if (diff < 0) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);  // full
+        return;
+      }
+      if (diff > 0) {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+
+    sl->rec.format = format;
+    sl->rec.lvl = lvl;
+    encoder enc{sl->rec};
+    (enc.add(args), ...);
+    sl->seq.store(pos + 1, std::memory_order_release);
+
+    if ((pending_.fetch_add(1, std::memory_order_release) & ~kStopBit) == 0) {
+      pending_.notify_one();
+    }
+  }
+
+ private:
+  static constexpr uint32_t kStopBit = 1u << 31;
+
+  struct slot {
+    std::atomic<uint64_t> seq;
+    record rec;
+  };
+
+  void drain() noexcept {
+    char line[1024];
+    for (;;) {
+      const uint32_t pending = pending_.load(std::memory_order_acquire);
+      const uint32_t count = pending & ~kStopBit;
+      if (count == 0) {
+        if ((pending & kStopBit) != 0) {
+          break;
+        }
+        pending_.wait(pending, std::memory_order_acquire);
+        continue;
+      }
+
+      for (uint32_t i = 0; i < count; ++i) {
+        slot& sl = slots_[head_ & (kCapacity - 1)];
+        // counted records are published, but not necessarily in slot order; the one at head is moments away
+        while (sl.seq.load(std::memory_order_acquire) != head_ + 1) {
+          std::this_thread::yield();
+        }
+        format(sl.rec, line, sizeof(line));
+        const level lvl = sl.rec.lvl;
+        sl.seq.store(head_ + kCapacity, std::memory_order_release);
+        ++head_;
+        write(lvl, line);
+      }
+      pending_.fetch_sub(count, std::memory_order_release);
+
+      if (const auto dropped = dropped_.exchange(0, std::memory_order_relaxed); dropped != 0) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "%u log records dropped, ring full\n", dropped);
+      }
+    }
+  }
+
+  static void write(level lvl, const char* line) noexcept {
+    switch (lvl) {
+      case kWarn:
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "%s", line);
+        break;
+      case kError:
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s", line);
+        break;
+      default:
+        SDL_Log("%s", line);
+        break;
+    }
+  }
+
+  std::unique_ptr<slot[]> slots_;
+  alignas(64) std::atomic<uint64_t> tail_{0};
+  alignas(64) std::atomic<uint32_t> pending_{0};
+  std::atomic<uint32_t> dropped_{0};
+  uint64_t head_ = 0;  // writer thread only
+  std::thread writer_;
+};
+
+}  // namespace logging
+
+#define AEOM_LOG(lvl, ...)                                  \
+  do {                                                      \
+    if constexpr ((lvl) >= logging::kMinLevel) {            \
+      logging::sink::get().push((lvl), __VA_ARGS__);        \
+    }                                                       \
+  } while (false)
+
+#define LOG_DEBUG(...) AEOM_LOG(logging::kDebug, __VA_ARGS__)
+#define LOG_INFO(...) AEOM_LOG(logging::kInfo, __VA_ARGS__)
+#define LOG_WARN(...) AEOM_LOG(logging::kWarn, __VA_ARGS__)
+#define LOG_ERROR(...) AEOM_LOG(logging::kError, __VA_ARGS__)
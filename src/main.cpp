@@ -3,70 +3,189 @@
 #include <SDL3_image/SDL_image.h>
 #include <SDL3_ttf/SDL_ttf.h>
 
+#include "asset_watch.hpp"
 #include "ecs.hpp"
 #include "globals.hpp"
+#include "input.hpp"
+#include "job_system.hpp"
+#include "log.hpp"
+#include "profiler.hpp"
+#include "replay.hpp"
+#include "scene.hpp"
+#include "scene_file.hpp"
+#include "scheduler.hpp"
 #include "texture.hpp"
 #include "timer.hpp"
 
-// Texture loading
-bool load_assets(SDL_Renderer* renderer, TTF_Font* font, texture_manager& texman) noexcept {
-  texman.load_texture_named(renderer, "assets/head0_256.png", "head0_256");
-  texman.load_texture_named(renderer, "assets/head1_256.png", "head1_256");
-  texman.load_texture_named(renderer, "assets/left_eye.png", "left_eye");
-  texman.load_texture_named(renderer, "assets/right_eye.png", "right_eye");
-  texman.load_texture_named(renderer, "assets/table.png", "table");
-  texman.load_texture_named(renderer, "assets/room.png", "room");
-  texman.load_texture_from_text_named(renderer, font, "000000", "score", 0x00, 0x00, 0x00, 0xFF);
-
-  return true;
-}
-
-void game_loop(ECS& ecs, game_state& state, SDL_Renderer* renderer) noexcept {
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// F3 dumps this many frames of profiler zones
+constexpr uint32_t kTraceFrames = 300;
+
+// longest wall time one frame may feed the simulation; past that it slows down instead of spiralling
+constexpr uint64_t kMaxFrameNs = 250'000'000;
+static_assert(kMaxFrameNs / kNsPerTick < std::numeric_limits<decltype(input_frame::ticks)>::max(), "a frame's ticks must fit the input log");
+
+enum class present_mode { capped, vsync, uncapped };
+
+// restart: the scene as it was before the first frame; F5 goes back to it
+void game_loop(ECS& ecs,
+               game_state& state,
+               SDL_Renderer* renderer,
+               present_mode mode,
+               input_recorder& recorder,
+               std::span<const std::byte> restart,
+               asset_watcher& watcher) noexcept {
   bool quit = false;
   SDL_Event e;
-  timer cap_timer;
+  frame_pacer pacer(mode == present_mode::capped ? kNsPerFrame : 0);
+
+  job_system jobs;
+  ecs.jobs = &jobs;
+  scheduler sim;
+  ecs.register_systems(sim, state);
+
+  uint64_t previous = SDL_GetTicksNS();
+  uint64_t accumulator = kNsPerTick;  // first frame simulates one tick
+
+  input_frame input;
 
   while (!quit) {
-    cap_timer.start();
+    PROFILE_FRAME();
+    ecs.begin_frame();
+
+    // hot reload: changed images decode on workers; the ones done swap in here, between frames
+    watcher.drain([&](const std::string& path) {
+      if (!ecs.manager.reload_texture_async(path)) {
+        LOG_DEBUG("%s changed but is not a loaded texture\n", path.c_str());
+      }
+    });
+    const uint32_t reloading = ecs.manager.upload_ready(renderer);
+    if (ecs.manager.take_reloaded() != 0) {
+      ecs.invalidate_layers();
+    }
 
+    const uint64_t now = SDL_GetTicksNS();
+    accumulator += std::min(now - previous, kMaxFrameNs);
+    previous = now;
+
+    input.events.clear();
     while (SDL_PollEvent(&e)) {
+      input_event ev;
       if (e.type == SDL_EVENT_QUIT)
         quit = true;
-      else
-        ecs.handle_event(e, state);
+      else if (e.type == SDL_EVENT_KEY_DOWN && e.key.key == SDLK_F3 && !e.key.repeat)
+        profiler::dump_chrome_trace("trace.json", kTraceFrames);
+      else if (e.type == SDL_EVENT_KEY_DOWN && e.key.key == SDLK_F5 && !e.key.repeat && !recorder.is_open())
+        load_scene(ecs, state, ecs.manager, restart);  // not while recording: the log could not replay it
+      else if (e.type == SDL_EVENT_RENDER_TARGETS_RESET || e.type == SDL_EVENT_RENDER_DEVICE_RESET)
+        ecs.reset_render_targets();
+      else if (input_event::from_sdl(e, ev) && !(ev.type == input_event::kMotion && !input.events.empty() && input.events.back().type == ev.type))
+        input.events.emplace_back(ev);  // back-to-back motions see the same mouse, so one does
     }
 
+    // everything below sees only `input`, so a recording replays it exactly
+    input.mouse = read_mouse();
+    ecs.mouse = input.mouse;
+    for (const auto& ev : input.events) {
+      SDL_Event replayed = ev.to_sdl();
+      ecs.handle_event(replayed, state);
+    }
+    ecs.events.dispatch();
+
     ecs.cleanup();
 
-    ecs.move_dragged();
-    ecs.move_tracked(state);
-    ecs.loop_logic(state);
+    // fixed-rate simulation; the render rate only decides how far to blend between ticks
+    input.ticks = 0;
+    while (accumulator >= kNsPerTick) {
+      sim.run(jobs);
 
-    ecs.move();
+      ++state.frame_counter;
+      ++input.ticks;
+      accumulator -= kNsPerTick;
+    }
 
-    SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
-    SDL_RenderClear(renderer);
+    if (recorder.is_open()) {
+      input.state_hash = ecs.state_hash(state);
+      recorder.write(input);
+    }
 
-    ecs.render();
+    // the background layer covers the whole frame, so there is no clear
+    ecs.render(static_cast<float>(accumulator) / kNsPerTick);
 
-    SDL_RenderPresent(renderer);
+    {
+      PROFILE_ZONE("present");
+      SDL_RenderPresent(renderer);
+    }
 
-    uint64_t frameNs = cap_timer.get_ticks_ns();
-    if (frameNs < kNsPerFrame) {
-      SDL_DelayNS(kNsPerFrame - frameNs);
+    {
+      PROFILE_ZONE("frame_cap");
+      pacer.wait();
+    }
+
+    // Nothing will change before the next game timer: block until input or that timer instead of drawing the same
+    // frame again, then account the slept ticks without running them. Off while recording, so logs stay tick-exact,
+    // and while reloaded images are decoding, so they show up as soon as they are done.
+    if (const uint64_t idle = recorder.is_open() || reloading != 0 ? 0 : ecs.idle_ticks(state); idle != 0) {
+      PROFILE_ZONE("idle");
+
+      const uint64_t due_ns = (idle + 1) * kNsPerTick - accumulator;  // the first busy tick runs on waking
+      const uint64_t since = SDL_GetTicksNS() - previous;
+      if (due_ns > since) {
+        SDL_WaitEventTimeout(nullptr, static_cast<Sint32>((due_ns - since + 999'999) / 1'000'000));
+      }
+
+      const uint64_t now = SDL_GetTicksNS();
+      const uint64_t elapsed = accumulator + (now - previous);
+      const uint64_t skipped = std::min(elapsed / kNsPerTick, idle);
+      state.frame_counter += skipped;
+      accumulator = std::min(elapsed - skipped * kNsPerTick, kMaxFrameNs);
+      previous = now;
     }
-    ++state.frame_counter;
   }
+
+  ecs.jobs = nullptr;
 }
 
 int main(int argc, char* args[]) {
+  // --vsync locks presents to the display, --uncapped draws as fast as possible; the simulation is the same either way.
+  // --record <file> logs the session's input for bench_frame --replay.
+  // --scene <file> loads a scene saved with --save-scene <file> instead of building the jam scene.
+  // --watch <dir> reloads images in <dir> (e.g. the source assets/) as they are saved.
+  present_mode mode = present_mode::capped;
+  const char* record_path = nullptr;
+  const char* scene_path = nullptr;
+  const char* save_scene_path = nullptr;
+  const char* watch_path = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    if (std::string_view{args[i]} == "--vsync") {
+      mode = present_mode::vsync;
+    } else if (std::string_view{args[i]} == "--uncapped") {
+      mode = present_mode::uncapped;
+    } else if (std::string_view{args[i]} == "--record" && i + 1 < argc) {
+      record_path = args[++i];
+    } else if (std::string_view{args[i]} == "--scene" && i + 1 < argc) {
+      scene_path = args[++i];
+    } else if (std::string_view{args[i]} == "--save-scene" && i + 1 < argc) {
+      save_scene_path = args[++i];
+    } else if (std::string_view{args[i]} == "--watch" && i + 1 < argc) {
+      watch_path = args[++i];
+    }
+  }
+
   if (SDL_Init(SDL_INIT_VIDEO) == false) {
-    SDL_Log("SDL_Init failed: %s", SDL_GetError());
+    LOG_ERROR("SDL_Init failed: %s", SDL_GetError());
     return 1;
   }
 
   if (TTF_Init() == false) {
-    SDL_Log("TTF_Init failed: %s\n", SDL_GetError());
+    LOG_ERROR("TTF_Init failed: %s\n", SDL_GetError());
     return 2;
   }
 
@@ -74,13 +193,18 @@ int main(int argc, char* args[]) {
   SDL_Renderer* renderer = nullptr;
 
   if (SDL_CreateWindowAndRenderer("All Eyes On Me", kScreenWidth, kScreenHeight, 0, &window, &renderer) == false) {
-    SDL_Log("SDL_CreateWindowAndRenderer failed: %s", SDL_GetError());
+    LOG_ERROR("SDL_CreateWindowAndRenderer failed: %s", SDL_GetError());
     SDL_Quit();
     return 3;
   }
 
+  if (mode == present_mode::vsync && SDL_SetRenderVSync(renderer, 1) == false) {
+    LOG_WARN("VSync unavailable, capping frames instead: %s\n", SDL_GetError());
+    mode = present_mode::capped;
+  }
+
   if (SDL_Surface* icon = IMG_Load("assets/icon.png"); icon == nullptr) {
-    SDL_Log("Unable to load image %s! SDL_image error: %s\n", "assets/icon.png", SDL_GetError());
+    LOG_WARN("Unable to load image %s! SDL_image error: %s\n", "assets/icon.png", SDL_GetError());
   } else {
     SDL_SetWindowIcon(window, icon);
     SDL_DestroySurface(icon);
@@ -89,13 +213,13 @@ int main(int argc, char* args[]) {
   TTF_Font* font = nullptr;
   std::string fontPath{"assets/press_start.ttf"};
   if (font = TTF_OpenFont(fontPath.c_str(), 56); font == nullptr) {
-    SDL_Log("Could not load %s! SDL_ttf Error: %s\n", fontPath.c_str(), SDL_GetError());
+    LOG_ERROR("Could not load %s! SDL_ttf Error: %s\n", fontPath.c_str(), SDL_GetError());
     return 4;
   }
 
   texture_manager manager;
   if (load_assets(renderer, font, manager) == false) {
-    SDL_Log("Unable to load assets!");
+    LOG_ERROR("Unable to load assets!");
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     TTF_CloseFont(font);
@@ -108,37 +232,52 @@ int main(int argc, char* args[]) {
   ECS ecs(renderer, font, manager);
   game_state state{0, 0, false, 100};
 
-  float center_x = 1.f * kScreenWidth / 2;
-  float center_y = 1.f * kScreenHeight / 2;
-
-  auto room_id = ecs.register_object(center_x, center_y);
-  ecs.add_texture(room_id, manager.get_texture_id("room"), kScreenWidth, kScreenHeight);
-
-  auto leye_id = ecs.register_object(335, 330 + 70);
-  ecs.add_texture(leye_id, manager.get_texture_id("left_eye"), 100, 100);
-  ecs.add_tracker(leye_id, 335, 330, 23);
+  // without a GPU every redrawn pixel is CPU time
+  const char* renderer_name = SDL_GetRendererName(renderer);
+  ecs.damage_tracking = renderer_name != nullptr && std::string_view{renderer_name} == SDL_SOFTWARE_RENDERER;
+  if (ecs.damage_tracking) {
+    manager.set_scaled_budget(texture_manager::kDefaultScaledBudget);
+  }
 
-  auto reye_id = ecs.register_object(462, 335 + 70);
-  ecs.add_texture(reye_id, manager.get_texture_id("right_eye"), 100, 100);
-  ecs.add_tracker(reye_id, 462, 335, 23);
+  // replays rebuild the scene from its scene_config, so recordings always start from the built one
+  if (scene_path != nullptr && record_path != nullptr) {
+    LOG_WARN("--record runs the built scene; ignoring --scene\n");
+    scene_path = nullptr;
+  }
 
-  auto head_id = ecs.register_object(center_x, center_y + 180);
-  ecs.add_texture(head_id, manager.get_texture_id("head0_256"), 512, 512);
-  ecs.add_tracker(head_id, center_x, center_y + 80, 10);
-  state.head_texture_next = manager.get_texture_id("head1_256");
-  state.head_id = head_id.position_id;
+  const scene_config scene;
+  if (scene_path == nullptr) {
+    build_scene(ecs, state, manager, scene);
+  } else {
+    wire_scene(ecs, state);
+    if (!load_scene_file(scene_path, ecs, state, manager)) {
+      SDL_DestroyRenderer(renderer);
+      SDL_DestroyWindow(window);
+      TTF_CloseFont(font);
+      SDL_Quit();
+      TTF_Quit();
+      return 6;
+    }
+  }
+  if (save_scene_path != nullptr) {
+    save_scene_file(save_scene_path, ecs, state, manager);
+  }
 
-  auto head_trigger_id = ecs.register_object(center_x, center_y);
-  ecs.add_dimetions(head_trigger_id, 230, 200);
-  ecs.make_clickable(head_trigger_id);
+  std::vector<std::byte> restart;
+  save_scene(ecs, state, manager, restart);
 
-  auto table_id = ecs.register_object(center_x, center_y + 200);
-  ecs.add_texture(table_id, manager.get_texture_id("table"), 800, 200);
+  input_recorder recorder;
+  if (record_path != nullptr) {
+    recorder.open(record_path, scene);
+  }
 
-  auto score_id = ecs.register_object(122, 38);
-  ecs.add_texture(score_id, manager.get_texture_id("score"), 224, 56);
+  asset_watcher watcher;
+  if (watch_path != nullptr) {
+    watcher.start(watch_path);
+  }
 
-  game_loop(ecs, state, renderer);
+  game_loop(ecs, state, renderer, mode, recorder, restart, watcher);
+  watcher.stop();
 
   SDL_DestroyRenderer(renderer);
   SDL_DestroyWindow(window);
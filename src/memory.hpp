@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Heap accounting. Counts only where AEOM_DEFINE_ALLOCATION_COUNTER() is expanded, once, in the translation unit
+// holding main(); elsewhere the counters stay at zero.
+namespace alloc_stats {
+
+inline std::atomic<uint64_t> allocations{0};
+inline std::atomic<uint64_t> bytes{0};
+
+inline uint64_t count() noexcept { return allocations.load(std::memory_order_relaxed); }
+
+inline void* counted_alloc(std::size_t n, std::size_t align) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  bytes.fetch_add(n, std::memory_order_relaxed);
+  n = std::max<std::size_t>(n, 1);
+  void* p = align > alignof(std::max_align_t) ? std::aligned_alloc(align, (n + align - 1) / align * align) : std::malloc(n);
+  if (p == nullptr) {
+    throw std::bad_alloc{};
+  }
+  return p;
+}
+
+// GCC pairs the counted operator new with this free once both are inlined and warns; they do match
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+inline void counted_free(void* p) noexcept { std::free(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+}  // namespace alloc_stats
+
+#define AEOM_DEFINE_ALLOCATION_COUNTER()                                                                                     \
+  void* operator new(std::size_t n) { return alloc_stats::counted_alloc(n, 0); }                                             \
+  void* operator new[](std::size_t n) { return alloc_stats::counted_alloc(n, 0); }                                           \
+  void* operator new(std::size_t n, std::align_val_t a) { return alloc_stats::counted_alloc(n, static_cast<std::size_t>(a)); } \
+  void* operator new[](std::size_t n, std::align_val_t a) { return alloc_stats::counted_alloc(n, static_cast<std::size_t>(a)); } \
+  void operator delete(void* p) noexcept { alloc_stats::counted_free(p); }                                                   \
+  void operator delete[](void* p) noexcept { alloc_stats::counted_free(p); }                                                 \
+  void operator delete(void* p, std::size_t) noexcept { alloc_stats::counted_free(p); }                                      \
+  void operator delete[](void* p, std::size_t) noexcept { alloc_stats::counted_free(p); }                                    \
+  void operator delete(void* p, std::align_val_t) noexcept { alloc_stats::counted_free(p); }                                 \
+  void operator delete[](void* p, std::align_val_t) noexcept { alloc_stats::counted_free(p); }                               \
+  void operator delete(void* p, std::size_t, std::align_val_t) noexcept { alloc_stats::counted_free(p); }                    \
+  void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { alloc_stats::counted_free(p); }
+
+// Growable array in fixed-size chunks. Growing adds a chunk instead of moving elements, so addresses stay valid until
+// the element itself is removed, and no push costs more than one chunk allocation. Rows [i, end of i's chunk) are
+// contiguous; popped chunks are kept for reuse. Elements must be trivially copyable.
+template <typename T, uint32_t ChunkRows = 4096>
+class chunked_vector {
+  static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>);
+  static_assert(std::has_single_bit(ChunkRows));
+
+ public:
+  static constexpr uint32_t kChunkRows = ChunkRows;
+
+  template <bool Const>
+  class basic_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+
+    basic_iterator() = default;
+    basic_iterator(std::conditional_t<Const, const chunked_vector*, chunked_vector*> v, uint32_t i) noexcept : v_{v}, i_{i} {}
+
+    reference operator*() const noexcept { return (*v_)[i_]; }
+    pointer operator->() const noexcept { return &(*v_)[i_]; }
+    basic_iterator& operator++() noexcept {
+      ++i_;
+      return *this;
+    }
+    basic_iterator operator++(int) noexcept { return {v_, i_++}; }
+    bool operator==(const basic_iterator& o) const noexcept { return i_ == o.i_; }
+
+   private:
+    std::conditional_t<Const, const chunked_vector*, chunked_vector*> v_ = nullptr;
+    uint32_t i_ = 0;
+  };
+
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
+  chunked_vector() = default;
+  chunked_vector(chunked_vector&&) noexcept = default;
+  chunked_vector& operator=(chunked_vector&&) noexcept = default;
+
+  [[nodiscard]] uint32_t size() const noexcept { return size_; }
+  [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+  [[nodiscard]] uint32_t capacity() const noexcept { return static_cast<uint32_t>(chunks_.size()) * kChunkRows; }
+
+  // allocates the chunks for `rows` up front
+  void reserve(uint32_t rows) {
+    chunks_.reserve((rows + kChunkRows - 1) / kChunkRows);
+    while (capacity() < rows) {
+      chunks_.emplace_back(std::make_unique_for_overwrite<T[]>(kChunkRows));
+    }
+  }
+
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    if (size_ == capacity()) {
+      reserve(size_ + 1);
+    }
+    T& slot = (*this)[size_++];
+    slot = T(std::forward<Args>(args)...);
+    return slot;
+  }
+
+  void pop_back() noexcept { --size_; }
+
+  // rows added this way hold whatever the chunk held before; for bulk fills that overwrite them
+  void resize_for_overwrite(uint32_t rows) {
+    reserve(rows);
+    size_ = rows;
+  }
+
+  void clear() noexcept { size_ = 0; }
+
+  // f(data, count) over the contiguous runs holding the elements, in order
+  template <typename F>
+  void for_each_run(F&& f) {
+    for (uint32_t begin = 0; begin < size_; begin += kChunkRows) {
+      f(&(*this)[begin], std::min(size_ - begin, kChunkRows));
+    }
+  }
+  template <typename F>
+  void for_each_run(F&& f) const {
+    for (uint32_t begin = 0; begin < size_; begin += kChunkRows) {
+      f(&(*this)[begin], std::min(size_ - begin, kChunkRows));
+    }
+  }
+
+  T& operator[](uint32_t i) noexcept { return chunks_[i / kChunkRows][i % kChunkRows]; }
+  const T& operator[](uint32_t i) const noexcept { return chunks_[i / kChunkRows][i % kChunkRows]; }
+
+  T& back() noexcept { return (*this)[size_ - 1]; }
+  const T& back() const noexcept { return (*this)[size_ - 1]; }
+
+  iterator begin() noexcept { return {this, 0}; }
+  iterator end() noexcept { return {this, size_}; }
+  const_iterator begin() const noexcept { return {this, 0}; }
+  const_iterator end() const noexcept { return {this, size_}; }
+
+ private:
+  std::vector<std::unique_ptr<T[]>> chunks_;
+  uint32_t size_ = 0;
+};
+
+// Bump allocator for data that lives one frame. reset() at the top of the frame recycles everything at once; a frame
+// that outgrows the block gets overflow blocks, and the next reset folds them into one big enough block.
+class frame_arena {
+ public:
+  static constexpr std::size_t kDefaultCapacity = 256 * 1024;
+
+  explicit frame_arena(std::size_t capacity = kDefaultCapacity) : block_{std::make_unique_for_overwrite<std::byte[]>(capacity)}, capacity_{capacity} {}
+
+  frame_arena(const frame_arena&) = delete;
+  frame_arena& operator=(const frame_arena&) = delete;
+
+  [[nodiscard]] void* allocate(std::size_t n, std::size_t align = alignof(std::max_align_t)) {
+    const std::size_t at = (used_ + align - 1) & ~(align - 1);
+    if (at + n <= capacity_) {
+      used_ = at + n;
+      high_water_ = std::max(high_water_, used_);
+      return block_.get() + at;
+    }
+
+    overflow_bytes_ += n + align;
+    high_water_ = std::max(high_water_, capacity_ + overflow_bytes_);
+    auto& extra = overflow_.emplace_back(std::make_unique_for_overwrite<std::byte[]>(n + align));
+    return extra.get() + ((align - reinterpret_cast<uintptr_t>(extra.get()) % align) % align);
+  }
+
+  // n default-initialized Ts; never destroyed, so T must be trivially destructible
+  template <typename T>
+  [[nodiscard]] T* make_array(std::size_t n) {
+    static_assert(std::is_trivially_destructible_v<T>);
+    T* p = static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+    std::uninitialized_default_construct_n(p, n);
+    return p;
+  }
+
+  void reset() {
+    if (!overflow_.empty()) {
+      overflow_.clear();
+      capacity_ = high_water_;
+      block_ = std::make_unique_for_overwrite<std::byte[]>(capacity_);
+      overflow_bytes_ = 0;
+    }
+    used_ = 0;
+  }
+
+  [[nodiscard]] std::size_t used() const noexcept { return used_; }
+  [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+
+ private:
+  std::unique_ptr<std::byte[]> block_;
+  std::size_t capacity_;
+  std::size_t used_ = 0;
+  std::size_t high_water_ = 0;
+  std::size_t overflow_bytes_ = 0;
+  std::vector<std::unique_ptr<std::byte[]>> overflow_;
+};
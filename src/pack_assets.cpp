@@ -0,0 +1,102 @@
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+
+#include "asset_pack.hpp"
+#include "atlas.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Build-time asset packer: decodes images once so the game maps pixels instead of inflating PNGs on every launch.
+//
+//   pack_assets <out.pack> <image>...
+//
+// Entries are named after the file stem ("assets/room.png" -> "room").
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    SDL_Log("usage: pack_assets <out.pack> <image>...\n");
+    return 1;
+  }
+
+  std::vector<asset_pack::entry> entries;
+  std::vector<SDL_Surface*> pixels;
+  int rc = 0;
+
+  for (int i = 2; i < argc && rc == 0; ++i) {
+    const std::string name = std::filesystem::path(argv[i]).stem().string();
+    if (name.size() >= asset_pack::kNameLength) {
+      SDL_Log("Asset name %s is too long for the pack\n", name.c_str());
+      rc = 2;
+      break;
+    }
+
+    SDL_Surface* loaded = IMG_Load(argv[i]);
+    if (loaded == nullptr) {
+      SDL_Log("Unable to load image %s! SDL_image error: %s\n", argv[i], SDL_GetError());
+      rc = 2;
+      break;
+    }
+
+    // atlas-sized images are stored extruded so the game can upload them untouched
+    const bool padded = fits_atlas(loaded->w, loaded->h);
+    SDL_Surface* out = padded ? extrude(loaded) : SDL_ConvertSurface(loaded, SDL_PIXELFORMAT_ARGB8888);
+    SDL_DestroySurface(loaded);
+    if (out == nullptr) {
+      SDL_Log("Unable to convert image %s! SDL error: %s\n", argv[i], SDL_GetError());
+      rc = 2;
+      break;
+    }
+
+    asset_pack::entry e{};
+    name.copy(e.name, asset_pack::kNameLength - 1);
+    e.width = static_cast<uint32_t>(out->w);
+    e.height = static_cast<uint32_t>(out->h);
+    e.pitch = static_cast<uint32_t>(out->pitch);
+    e.padding = padded ? kAtlasPadding : 0;
+    e.size = static_cast<uint64_t>(out->pitch) * out->h;
+    entries.emplace_back(e);
+    pixels.emplace_back(out);
+  }
+
+  if (rc == 0) {
+    uint64_t offset = asset_pack::align_up(sizeof(asset_pack::header) + entries.size() * sizeof(asset_pack::entry));
+    for (auto& e : entries) {
+      e.offset = offset;
+      offset = asset_pack::align_up(offset + e.size);
+    }
+
+    std::FILE* out = std::fopen(argv[1], "wb");
+    if (out == nullptr) {
+      SDL_Log("Unable to open %s\n", argv[1]);
+      rc = 3;
+    } else {
+      const asset_pack::header head{asset_pack::kMagic, asset_pack::kVersion, static_cast<uint32_t>(entries.size()), SDL_PIXELFORMAT_ARGB8888};
+      bool ok = std::fwrite(&head, sizeof(head), 1, out) == 1;
+      ok = ok && (entries.empty() || std::fwrite(entries.data(), sizeof(asset_pack::entry), entries.size(), out) == entries.size());
+
+      const std::vector<uint8_t> zeros(asset_pack::kAlignment, 0);
+      uint64_t written = sizeof(head) + entries.size() * sizeof(asset_pack::entry);
+      for (std::size_t i = 0; i < entries.size() && ok; ++i) {
+        ok = std::fwrite(zeros.data(), 1, entries[i].offset - written, out) == entries[i].offset - written;
+        ok = ok && std::fwrite(pixels[i]->pixels, 1, entries[i].size, out) == entries[i].size;
+        written = entries[i].offset + entries[i].size;
+      }
+
+      ok = std::fclose(out) == 0 && ok;
+      if (!ok) {
+        SDL_Log("Unable to write %s\n", argv[1]);
+        rc = 3;
+      } else {
+        SDL_Log("pack_assets: wrote %zu images to %s\n", entries.size(), argv[1]);
+      }
+    }
+  }
+
+  for (auto* s : pixels) {
+    SDL_DestroySurface(s);
+  }
+  return rc;
+}
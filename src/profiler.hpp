@@ -0,0 +1,186 @@
+#pragma once
+
+// Scoped frame profiler. Build with AEOM_PROFILE defined (cmake -DAEOM_PROFILE=ON) to record zones; otherwise
+// PROFILE_ZONE/PROFILE_FRAME expand to nothing and dump_chrome_trace() is a stub.
+
+#include <SDL3/SDL.h>
+
+#include "log.hpp"
+
+#include <cstdint>
+
+#ifdef AEOM_PROFILE
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace profiler {
+
+inline constexpr const char* kFrameZone = "frame";
+
+struct zone_event {
+  const char* name;  // string literal; compared by pointer
+  uint64_t start_ns;
+  uint64_t end_ns;
+};
+
+// Single-writer ring owned by one thread. Dumps read it while the writer keeps pushing, so every slot is a small
+// seqlock of atomics: a reader keeps only events whose slot held the same ring position before and after the copy.
+class zone_ring {
+ public:
+  static constexpr uint32_t kCapacity = 1 << 15;
+
+  explicit zone_ring(uint32_t tid) noexcept : tid_{tid} {}
+
+  void push(const zone_event& ev) noexcept {
+    const auto head = head_.load(std::memory_order_relaxed);
+    auto& s = slots_[head & (kCapacity - 1)];
+    s.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    s.name.store(ev.name, std::memory_order_relaxed);
+    s.start_ns.store(ev.start_ns, std::memory_order_relaxed);
+    s.end_ns.store(ev.end_ns, std::memory_order_relaxed);
+    s.seq.store(head + 1, std::memory_order_release);
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  template <typename F>
+  void snapshot(F&& f) const noexcept {
+    const auto head = head_.load(std::memory_order_acquire);
+    const auto first = head > kCapacity ? head - kCapacity : 0;
+    for (auto i = first; i < head; ++i) {
+      const auto& s = slots_[i & (kCapacity - 1)];
+      if (s.seq.load(std::memory_order_acquire) != i + 1) {
+        continue;  // lapped
+      }
+      const zone_event ev{s.name.load(std::memory_order_relaxed), s.start_ns.load(std::memory_order_relaxed), s.end_ns.load(std::memory_order_relaxed)};
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (s.seq.load(std::memory_order_relaxed) == i + 1) {
+        f(ev);
+      }
+    }
+  }
+
+  [[nodiscard]] uint32_t tid() const noexcept { return tid_; }
+
+ private:
+  // seq: ring position + 1 of the event held, 0 while it is being written
+  struct slot {
+    std::atomic<uint64_t> seq{0};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> start_ns{0};
+    std::atomic<uint64_t> end_ns{0};
+  };
+
+  std::array<slot, kCapacity> slots_{};
+  std::atomic<uint64_t> head_{0};
+  uint32_t tid_;
+};
+
+struct registry {
+  std::mutex mutex;  // taken once per thread on first zone and by dumps, never per zone
+  std::vector<std::unique_ptr<zone_ring>> rings;
+
+  static registry& get() noexcept {
+    static registry r;
+    return r;
+  }
+};
+
+inline zone_ring& local_ring() noexcept {
+  thread_local zone_ring* ring = [] {
+    auto& reg = registry::get();
+    std::lock_guard lock{reg.mutex};
+    reg.rings.emplace_back(std::make_unique<zone_ring>(static_cast<uint32_t>(reg.rings.size())));
+    return reg.rings.back().get();
+  }();
+  return *ring;
+}
+
+class scoped_zone {
+ public:
+  explicit scoped_zone(const char* name) noexcept : name_{name}, start_{SDL_GetTicksNS()} {}
+  ~scoped_zone() { local_ring().push({name_, start_, SDL_GetTicksNS()}); }
+
+  scoped_zone(const scoped_zone&) = delete;
+  scoped_zone& operator=(const scoped_zone&) = delete;
+
+ private:
+  const char* name_;
+  uint64_t start_;
+};
+
+// writes every zone of the last `frames` frames in Chrome trace-event format (chrome://tracing, Perfetto)
+inline bool dump_chrome_trace(const char* path, uint32_t frames) noexcept {
+  struct tagged {
+    zone_event ev;
+    uint32_t tid;
+  };
+
+  std::vector<tagged> events;
+  {
+    auto& reg = registry::get();
+    std::lock_guard lock{reg.mutex};
+    for (const auto& ring : reg.rings) {
+      ring->snapshot([&](const zone_event& ev) { events.emplace_back(ev, ring->tid()); });
+    }
+  }
+
+  std::vector<uint64_t> frame_starts;
+  for (const auto& t : events) {
+    if (t.ev.name == kFrameZone) {
+      frame_starts.emplace_back(t.ev.start_ns);
+    }
+  }
+  std::sort(frame_starts.begin(), frame_starts.end());
+
+  const uint64_t cutoff = frame_starts.size() > frames ? frame_starts[frame_starts.size() - frames] : 0;
+  std::erase_if(events, [&](const tagged& t) { return t.ev.start_ns < cutoff; });
+  std::sort(events.begin(), events.end(), [](const tagged& a, const tagged& b) { return a.ev.start_ns < b.ev.start_ns; });
+
+  std::FILE* out = std::fopen(path, "w");
+  if (out == nullptr) {
+    LOG_ERROR("Unable to open trace file %s\n", path);
+    return false;
+  }
+
+  std::fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    const auto& [ev, tid] = events[i];
+    std::fprintf(out, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}%s\n", ev.name, tid, ev.start_ns / 1000.0,
+                 (ev.end_ns - ev.start_ns) / 1000.0, i + 1 < events.size() ? "," : "");
+  }
+  std::fprintf(out, "]}\n");
+  std::fclose(out);
+
+  LOG_INFO("profiler: wrote %zu zones to %s\n", events.size(), path);
+  return true;
+}
+
+}  // namespace profiler
+
+#define PROFILER_CONCAT_IMPL(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_IMPL(a, b)
+#define PROFILE_ZONE(name) ::profiler::scoped_zone PROFILER_CONCAT(profile_zone_, __LINE__)(name)
+#define PROFILE_FRAME() PROFILE_ZONE(::profiler::kFrameZone)
+
+#else
+
+namespace profiler {
+
+inline bool dump_chrome_trace(const char*, uint32_t) noexcept {
+  LOG_WARN("profiler: built without AEOM_PROFILE\n");
+  return false;
+}
+
+}  // namespace profiler
+
+#define PROFILE_ZONE(name) static_cast<void>(0)
+#define PROFILE_FRAME() static_cast<void>(0)
+
+#endif
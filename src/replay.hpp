@@ -0,0 +1,160 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include "globals.hpp"
+#include "input.hpp"
+#include "log.hpp"
+#include "scene.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Input log for reproducible runs. The game records one entry per rendered frame (--record); bench_frame --replay
+// feeds the log back without pacing and checks the state hash after every frame.
+//
+//   header: magic, version, sim rate, scene_config
+//   frame:  ticks u16 | focused u8 | buttons u8 | event count u16 | mouse x f32 | mouse y f32 | state hash u64
+//           | events (type u8, button u8) * count
+//
+// Native-endian; logs are meant for the machine (or at least the architecture) that recorded them.
+
+struct input_frame {
+  mouse_state mouse;
+  std::vector<input_event> events;
+  uint16_t ticks = 0;  // sim ticks the frame ran; a long frame at a high sim rate runs hundreds
+  uint64_t state_hash = 0;
+};
+
+namespace replay_format {
+
+constexpr uint32_t kMagic = 0x52494541;  // "AEIR"
+constexpr uint32_t kVersion = 3;  // 2: sim rate in the header; trackers spring exactly, so older hashes differ. 3: u16 ticks
+
+struct header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t sim_hz;  // ticks only reproduce at the rate they were recorded at
+  uint32_t crowd_eyes;
+  uint32_t draggables;
+  uint32_t zones;
+};
+
+}  // namespace replay_format
+
+class input_recorder {
+ public:
+  input_recorder() = default;
+  input_recorder(const input_recorder&) = delete;
+  input_recorder& operator=(const input_recorder&) = delete;
+
+  ~input_recorder() { close(); }
+
+  bool open(const char* path, const scene_config& scene) noexcept {
+    close();
+    if (file_ = std::fopen(path, "wb"); file_ == nullptr) {
+      LOG_ERROR("Unable to open input log %s\n", path);
+      return false;
+    }
+
+    put(replay_format::header{replay_format::kMagic, replay_format::kVersion, kSimHz, scene.crowd_eyes, scene.draggables, scene.zones});
+    return true;
+  }
+
+  [[nodiscard]] bool is_open() const noexcept { return file_ != nullptr; }
+
+  void write(const input_frame& f) noexcept {
+    put(f.ticks);
+    put(static_cast<uint8_t>(f.mouse.focused));
+    put(static_cast<uint8_t>(f.mouse.buttons));
+    put(static_cast<uint16_t>(f.events.size()));
+    put(f.mouse.x);
+    put(f.mouse.y);
+    put(f.state_hash);
+    for (const auto& ev : f.events) {
+      put(static_cast<uint8_t>(ev.type));
+      put(ev.button);
+    }
+  }
+
+  void close() noexcept {
+    if (file_ != nullptr) {
+      std::fclose(file_);
+      file_ = nullptr;
+    }
+  }
+
+ private:
+  template <typename T>
+  void put(const T& v) noexcept {
+    std::fwrite(&v, sizeof(T), 1, file_);
+  }
+
+  std::FILE* file_ = nullptr;
+};
+
+class input_replay {
+ public:
+  input_replay() = default;
+  input_replay(const input_replay&) = delete;
+  input_replay& operator=(const input_replay&) = delete;
+
+  ~input_replay() {
+    if (file_ != nullptr) {
+      std::fclose(file_);
+    }
+  }
+
+  bool open(const char* path) noexcept {
+    if (file_ = std::fopen(path, "rb"); file_ == nullptr) {
+      LOG_ERROR("Unable to open input log %s\n", path);
+      return false;
+    }
+
+    replay_format::header head{};
+    if (!get(head) || head.magic != replay_format::kMagic || head.version != replay_format::kVersion) {
+      LOG_ERROR("%s is not an input log of this version\n", path);
+      return false;
+    }
+    if (head.sim_hz != kSimHz) {
+      LOG_ERROR("%s was recorded at %u ticks per second, this build runs %u\n", path, head.sim_hz, kSimHz);
+      return false;
+    }
+    scene_ = {head.crowd_eyes, head.draggables, head.zones};
+    return true;
+  }
+
+  // the scene the log was recorded against
+  [[nodiscard]] const scene_config& scene() const noexcept { return scene_; }
+
+  // false at the end of the log (or on a truncated frame)
+  bool next(input_frame& f) noexcept {
+    uint8_t focused = 0, buttons = 0;
+    uint16_t count = 0;
+    if (!get(f.ticks) || !get(focused) || !get(buttons) || !get(count) || !get(f.mouse.x) || !get(f.mouse.y) || !get(f.state_hash)) {
+      return false;
+    }
+    f.mouse.focused = focused != 0;
+    f.mouse.buttons = buttons;
+
+    f.events.resize(count);
+    for (auto& ev : f.events) {
+      uint8_t type = 0;
+      if (!get(type) || !get(ev.button) || type > input_event::kButtonUp) {
+        return false;
+      }
+      ev.type = static_cast<input_event::kind>(type);
+    }
+    return true;
+  }
+
+ private:
+  template <typename T>
+  bool get(T& v) noexcept {
+    return std::fread(&v, sizeof(T), 1, file_) == 1;
+  }
+
+  std::FILE* file_ = nullptr;
+  scene_config scene_;
+};
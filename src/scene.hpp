@@ -0,0 +1,120 @@
+#pragma once
+
+#include "ecs.hpp"
+#include "globals.hpp"
+#include "texture.hpp"
+
+#include <SDL3/SDL.h>
+#include <SDL3_ttf/SDL_ttf.h>
+
+#include <cstdint>
+
+// extra load on top of the jam scene; all zero reproduces the game
+struct scene_config {
+  uint32_t crowd_eyes = 0;  // free-floating tracked eyes
+  uint32_t draggables = 0;
+  uint32_t zones = 0;
+};
+
+// Texture loading
+inline bool load_assets(SDL_Renderer* renderer, TTF_Font* font, texture_manager& texman) noexcept {
+  // the build's pre-decoded pack; loose PNGs when running without one
+  const bool packed = texman.load_pack(renderer, "assets/assets.pack");
+  if (!packed) {
+    // images decode in parallel while the glyphs rasterize here
+    texman.load_texture_async("assets/head0_256.png", "head0_256");
+    texman.load_texture_async("assets/head1_256.png", "head1_256");
+    texman.load_texture_async("assets/left_eye.png", "left_eye");
+    texman.load_texture_async("assets/right_eye.png", "right_eye");
+    texman.load_texture_async("assets/table.png", "table");
+    texman.load_texture_async("assets/room.png", "room");
+  }
+
+  const bool glyphs_ok = texman.load_glyphs(renderer, font, 0x00, 0x00, 0x00, 0xFF);
+  const bool images_ok = packed || texman.wait_loads(renderer);
+
+  return glyphs_ok && images_ok;
+}
+
+// gameplay reactions; entities only name the events, so a loaded scene needs these as much as a built one
+inline void wire_scene(ECS& ecs, game_state& state) {
+  // releasing the head makes it blink
+  ecs.events.subscribe(kEventBlink, [&ecs, &state](const game_event&) {
+    if (!state.is_eyes_closed) {
+      ecs.close_eyes(state);
+    }
+  });
+}
+
+inline void build_scene(ECS& ecs, game_state& state, texture_manager& manager, const scene_config& cfg = {}) noexcept {
+  wire_scene(ecs, state);
+
+  float center_x = 1.f * kScreenWidth / 2;
+  float center_y = 1.f * kScreenHeight / 2;
+
+  auto room_id = ecs.register_object(center_x, center_y);
+  ecs.add_texture(room_id, manager.get_texture_id("room"), kScreenWidth, kScreenHeight);
+  ecs.set_layer(room_id, kLayerBackground);
+
+  auto leye_id = ecs.register_object(335, 330 + 70);
+  ecs.add_texture(leye_id, manager.get_texture_id("left_eye"), 100, 100);
+  ecs.add_tracker(leye_id, 335, 330, 23);
+
+  auto reye_id = ecs.register_object(462, 335 + 70);
+  ecs.add_texture(reye_id, manager.get_texture_id("right_eye"), 100, 100);
+  ecs.add_tracker(reye_id, 462, 335, 23);
+
+  auto head_id = ecs.register_object(center_x, center_y + 180);
+  ecs.add_texture(head_id, manager.get_texture_id("head0_256"), 512, 512);
+  ecs.add_tracker(head_id, center_x, center_y + 80, 10);
+  state.head_texture_next = manager.get_texture_id("head1_256");
+  state.head_id = head_id;
+
+  auto head_trigger_id = ecs.register_object(center_x, center_y);
+  ecs.add_dimetions(head_trigger_id, 230, 200);
+  ecs.make_clickable(head_trigger_id, kEventBlink);
+
+  auto table_id = ecs.register_object(center_x, center_y + 200);
+  ecs.add_texture(table_id, manager.get_texture_id("table"), 800, 200);
+  ecs.set_layer(table_id, kLayerForeground);
+
+  auto score_id = ecs.register_object(122, 38);
+  ecs.add_text(score_id, "000000", 224, 56);
+  ecs.set_layer(score_id, kLayerUi);
+  state.score_id = score_id;
+
+  // stress load, laid out deterministically so runs are comparable
+  uint64_t seed = 1;
+  auto next_coord = [&](uint64_t range) -> float {
+    seed = lcg32(seed);
+    return static_cast<float>((seed >> 8) % range);
+  };
+
+  ecs.reserve<texture_size, drawable, mouse_tracker, motion>(cfg.crowd_eyes);
+  ecs.reserve<texture_size, drawable, object_size, drag, draggable>(cfg.draggables);
+  ecs.reserve<object_size, trigger_zone>(cfg.zones);
+
+  const uint32_t eye_textures[2] = {manager.get_texture_id("left_eye"), manager.get_texture_id("right_eye")};
+  for (uint32_t i = 0; i < cfg.crowd_eyes; ++i) {
+    const float x = next_coord(kScreenWidth);
+    const float y = next_coord(kScreenHeight);
+
+    auto eye = ecs.register_object(x, y);
+    ecs.add_texture(eye, eye_textures[i % 2], 24, 24);
+    ecs.add_tracker(eye, x, y, 6);
+  }
+
+  for (uint32_t i = 0; i < cfg.draggables; ++i) {
+    auto obj = ecs.register_object(next_coord(kScreenWidth), next_coord(kScreenHeight));
+    ecs.add_texture(obj, eye_textures[i % 2], 32, 32);
+    ecs.add_dimetions(obj, 32, 32);
+    ecs.add_drag(obj);
+    ecs.make_draggable(obj);
+  }
+
+  for (uint32_t i = 0; i < cfg.zones; ++i) {
+    auto zone = ecs.register_object(next_coord(kScreenWidth), next_coord(kScreenHeight));
+    ecs.add_dimetions(zone, 48, 48);
+    ecs.make_triggerable(zone);
+  }
+}
@@ -0,0 +1,390 @@
+#pragma once
+
+#include "ecs.hpp"
+#include "globals.hpp"
+#include "log.hpp"
+#include "texture.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <utility>
+#include <vector>
+
+// Binary scene: the ECS tables as they sit in memory, so loading is a few bulk copies into reserved chunks instead of
+// a register_object/add_* chain per entity. The same bytes snapshot a running game for quick restarts.
+//
+//   header | textures (name, id) * texture_count | entity records | free indices | game_state
+//   | dragged, pressed, entered entities
+//   | table * table_count: mask u32, rows u32, entity column, then one column per component in the mask, in
+//     component order
+//
+// Texture ids depend on load order, so they are stored with their names and remapped on load. Native-endian, like
+// the asset pack and input logs.
+namespace scene_format {
+
+constexpr uint32_t kMagic = 0x43534541;  // "AESC"
+constexpr uint32_t kVersion = 1;
+constexpr std::size_t kNameLength = 48;
+
+struct header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t sim_hz;  // game_state timers count ticks
+  uint32_t texture_count;
+  uint32_t record_count;
+  uint32_t free_count;
+  uint32_t table_count;
+  uint32_t next_draw_order;
+  uint32_t dragged;
+  uint32_t pressed;
+  uint32_t entered;
+};
+
+struct texture_name {
+  char name[kNameLength];  // nul-terminated
+  uint32_t id;
+};
+
+class writer {
+ public:
+  explicit writer(std::vector<std::byte>& out) noexcept : out_{out} {}
+
+  template <typename T>
+  void put(const T& v) {
+    put_bytes(&v, sizeof(T));
+  }
+
+  void put_bytes(const void* p, std::size_t n) {
+    const auto* b = static_cast<const std::byte*>(p);
+    out_.insert(out_.end(), b, b + n);
+  }
+
+  template <typename T>
+  void put_column(const chunked_vector<T>& col) {
+    col.for_each_run([&](const T* data, uint32_t n) { put_bytes(data, n * sizeof(T)); });
+  }
+
+ private:
+  std::vector<std::byte>& out_;
+};
+
+// reads from memory or straight from a file; every get fails once one has
+class reader {
+ public:
+  explicit reader(std::span<const std::byte> in) noexcept : in_{in} {}
+  explicit reader(std::FILE* file) noexcept : file_{file} {}
+
+  template <typename T>
+  bool get(T& v) noexcept {
+    return get_bytes(&v, sizeof(T));
+  }
+
+  bool get_bytes(void* p, std::size_t n) noexcept {
+    if (file_ != nullptr) {
+      ok_ = ok_ && std::fread(p, 1, n, file_) == n;
+      return ok_;
+    }
+    if (!ok_ || n > in_.size() - at_) {
+      ok_ = false;
+      return false;
+    }
+    std::memcpy(p, in_.data() + at_, n);
+    at_ += n;
+    return true;
+  }
+
+  template <typename T>
+  bool get_column(chunked_vector<T>& col) noexcept {
+    col.for_each_run([&](T* data, uint32_t n) { get_bytes(data, n * sizeof(T)); });
+    return ok_;
+  }
+
+  [[nodiscard]] bool ok() const noexcept { return ok_; }
+
+ private:
+  std::span<const std::byte> in_;
+  std::size_t at_ = 0;
+  std::FILE* file_ = nullptr;
+  bool ok_ = true;
+};
+
+}  // namespace scene_format
+
+// Appends the live scene to `out` (cleared first; its capacity is reused). Call between frames.
+inline void save_scene(const ECS& ecs, const game_state& state, const texture_manager& manager, std::vector<std::byte>& out) {
+  out.clear();
+  scene_format::writer w{out};
+
+  uint32_t texture_count = 0;
+  manager.for_each_name([&](const std::string& name, uint32_t) { texture_count += name.size() < scene_format::kNameLength; });
+
+  uint32_t table_count = 0;
+  for (const auto& arch : ecs.archetypes) {
+    table_count += arch.size() != 0;
+  }
+
+  w.put(scene_format::header{scene_format::kMagic, scene_format::kVersion, static_cast<uint32_t>(kSimHz), texture_count,
+                             static_cast<uint32_t>(ecs.records.size()), static_cast<uint32_t>(ecs.free_indices.size()), table_count,
+                             ecs.next_draw_order, static_cast<uint32_t>(ecs.dragged.size()), static_cast<uint32_t>(ecs.pressed.size()),
+                             static_cast<uint32_t>(ecs.entered.size())});
+
+  manager.for_each_name([&](const std::string& name, uint32_t tex_id) {
+    if (name.size() < scene_format::kNameLength) {
+      scene_format::texture_name entry{};
+      std::memcpy(entry.name, name.data(), name.size());
+      entry.id = tex_id;
+      w.put(entry);
+    }
+  });
+
+  // records point at tables by index; empty tables are skipped, so renumber
+  std::vector<uint32_t> table_index(ecs.archetypes.size(), ECS::kNoId);
+  for (uint32_t i = 0, next = 0; i < ecs.archetypes.size(); ++i) {
+    if (ecs.archetypes[i].size() != 0) {
+      table_index[i] = next++;
+    }
+  }
+  for (auto rec : ecs.records) {
+    if (rec.archetype != ECS::kNoId) {
+      rec.archetype = table_index[rec.archetype];
+    }
+    w.put(rec);
+  }
+  w.put_bytes(ecs.free_indices.data(), ecs.free_indices.size() * sizeof(uint32_t));
+
+  w.put(state);
+  for (const auto* list : {&ecs.dragged, &ecs.pressed, &ecs.entered}) {
+    w.put_bytes(list->data(), list->size() * sizeof(entity));
+  }
+
+  for (const auto& arch : ecs.archetypes) {
+    if (arch.size() == 0) {
+      continue;
+    }
+    w.put(arch.mask);
+    w.put(arch.size());
+    w.put_column(arch.entities);
+    components::for_each([&]<typename C>() {
+      if (arch.mask & components::bit<C>()) {
+        w.put_column(arch.column<C>());
+      }
+    });
+  }
+}
+
+// Replaces the ECS contents and `state` with a saved scene. Tables are sized once and filled column by column, reusing
+// the chunks of whatever scene was there before. Event handlers are not part of a scene: wire_scene() them once.
+// False on a malformed or foreign file, leaving the ECS empty and `state` as it was.
+inline bool load_scene(ECS& ecs, game_state& state, const texture_manager& manager, scene_format::reader& r) {
+  ecs.clear();
+
+  scene_format::header head{};
+  if (!r.get(head) || head.magic != scene_format::kMagic || head.version != scene_format::kVersion) {
+    LOG_ERROR("Not a scene of this version\n");
+    return false;
+  }
+  if (head.sim_hz != kSimHz) {
+    LOG_ERROR("Scene was saved at %u ticks per second, this build runs %u\n", head.sim_hz, static_cast<uint32_t>(kSimHz));
+    return false;
+  }
+  if (head.record_count > entity::kMaxEntities || head.free_count > head.record_count || head.table_count > head.record_count) {
+    LOG_ERROR("Scene is corrupt\n");
+    return false;
+  }
+
+  // (saved texture id, id in this run), sorted by saved id; ids missing from the table draw nothing
+  std::vector<std::pair<uint32_t, uint32_t>> texture_remap;
+  for (uint32_t i = 0; i < head.texture_count; ++i) {
+    scene_format::texture_name entry{};
+    if (!r.get(entry) || std::memchr(entry.name, '\0', scene_format::kNameLength) == nullptr) {
+      LOG_ERROR("Scene is corrupt\n");
+      return false;
+    }
+    texture_remap.emplace_back(entry.id, manager.get_texture_id(entry.name));
+    if (texture_remap.back().second == texture_manager::kNoImage) {
+      LOG_WARN("Scene texture %s is not loaded\n", entry.name);
+    }
+  }
+  std::ranges::sort(texture_remap);
+  if (std::ranges::adjacent_find(texture_remap, [](const auto& a, const auto& b) { return a.first == b.first; }) != texture_remap.end()) {
+    LOG_ERROR("Scene is corrupt\n");
+    return false;
+  }
+  const auto remap = [&](uint32_t& tex_id) {
+    const auto it = std::ranges::lower_bound(texture_remap, tex_id, {}, &std::pair<uint32_t, uint32_t>::first);
+    tex_id = it != texture_remap.end() && it->first == tex_id ? it->second : texture_manager::kNoImage;
+  };
+
+  ecs.records.resize(head.record_count);
+  ecs.free_indices.reserve(head.record_count);  // so deleting never grows it mid-game
+  ecs.free_indices.resize(head.free_count);
+  r.get_bytes(ecs.records.data(), ecs.records.size() * sizeof(ECS::entity_record));
+  r.get_bytes(ecs.free_indices.data(), ecs.free_indices.size() * sizeof(uint32_t));
+
+  // the caller's state is only replaced once the whole scene checks out
+  game_state loaded{};
+  r.get(loaded);
+  if (loaded.head_texture_next != texture_manager::kNoImage) {
+    remap(loaded.head_texture_next);
+  }
+
+  for (auto* list : {&ecs.dragged, &ecs.pressed, &ecs.entered}) {
+    const uint32_t n = list == &ecs.dragged ? head.dragged : list == &ecs.pressed ? head.pressed : head.entered;
+    if (n > head.record_count) {
+      LOG_ERROR("Scene is corrupt\n");
+      ecs.clear();
+      return false;
+    }
+    list->resize(n);
+    r.get_bytes(list->data(), n * sizeof(entity));
+  }
+
+  std::vector<uint32_t> table_index(head.table_count);
+  for (uint32_t t = 0; t < head.table_count && r.ok(); ++t) {
+    component_mask mask = 0;
+    uint32_t rows = 0;
+    if (!r.get(mask) || !r.get(rows) || rows > head.record_count || (mask & ~components::all()) != 0) {
+      LOG_ERROR("Scene is corrupt\n");
+      ecs.clear();
+      return false;
+    }
+
+    table_index[t] = ecs.find_or_create_archetype(mask);
+    auto& arch = ecs.archetypes[table_index[t]];
+    if (arch.size() != 0) {  // two saved tables with one mask
+      LOG_ERROR("Scene is corrupt\n");
+      ecs.clear();
+      return false;
+    }
+    arch.resize_for_overwrite(rows);
+    r.get_column(arch.entities);
+    components::for_each([&]<typename C>() {
+      if (mask & components::bit<C>()) {
+        r.get_column(arch.column<C>());
+      }
+    });
+
+    bool sane = true;
+    if (mask & components::bit<drawable>()) {
+      for (auto& dr : arch.column<drawable>()) {
+        if (dr.texture_id != texture_manager::kNoImage) {
+          remap(dr.texture_id);
+        }
+        sane = sane && dr.layer < kLayerCount;
+      }
+    }
+    if (mask & components::bit<text_label>()) {
+      for (const auto& label : arch.column<text_label>()) {
+        sane = sane && label.length <= label.chars.size();
+      }
+    }
+    if (!sane) {
+      LOG_ERROR("Scene is corrupt\n");
+      ecs.clear();
+      return false;
+    }
+  }
+
+  if (!r.ok()) {
+    LOG_ERROR("Scene is truncated\n");
+    ecs.clear();
+    return false;
+  }
+
+  // every live record has to land on a row that names it back; rows name distinct records, so equal counts mean no
+  // two records share a row
+  uint32_t live = 0;
+  for (auto& rec : ecs.records) {
+    if (rec.archetype == ECS::kNoId) {
+      continue;
+    }
+    if (rec.archetype >= head.table_count || rec.row >= ecs.archetypes[table_index[rec.archetype]].size()) {
+      LOG_ERROR("Scene is corrupt\n");
+      ecs.clear();
+      return false;
+    }
+    rec.archetype = table_index[rec.archetype];
+    ++live;
+  }
+
+  uint32_t rows = 0;
+  for (uint32_t a = 0; a < ecs.archetypes.size(); ++a) {
+    const auto& arch = ecs.archetypes[a];
+    for (uint32_t row = 0; row < arch.size(); ++row, ++rows) {
+      const entity e = arch.entities[row];
+      const auto idx = e.index();
+      if (idx >= ecs.records.size() || ecs.records[idx].archetype != a || ecs.records[idx].row != row ||
+          entity::make(idx, ecs.records[idx].generation) != e) {
+        LOG_ERROR("Scene is corrupt\n");
+        ecs.clear();
+        return false;
+      }
+    }
+  }
+
+  // free indices hand out dead records, each once
+  std::vector<bool> freed(ecs.records.size());
+  bool free_ok = rows == live;
+  for (const auto idx : ecs.free_indices) {
+    free_ok = free_ok && idx < ecs.records.size() && ecs.records[idx].archetype == ECS::kNoId && !freed[idx];
+    if (free_ok) {
+      freed[idx] = true;
+    }
+  }
+  if (!free_ok) {
+    LOG_ERROR("Scene is corrupt\n");
+    ecs.clear();
+    return false;
+  }
+
+  state = loaded;
+  ecs.next_draw_order = head.next_draw_order;
+
+  ecs.view<const position, const object_size>().each_entity(
+      [&](entity e, const position& pos, const object_size& dim) { ecs.grid.insert(e, aabb::from(pos, dim)); });
+  return true;
+}
+
+inline bool load_scene(ECS& ecs, game_state& state, const texture_manager& manager, std::span<const std::byte> bytes) {
+  scene_format::reader r{bytes};
+  return load_scene(ecs, state, manager, r);
+}
+
+inline bool save_scene_file(const char* path, const ECS& ecs, const game_state& state, const texture_manager& manager) {
+  std::vector<std::byte> bytes;
+  save_scene(ecs, state, manager, bytes);
+
+  std::FILE* file = std::fopen(path, "wb");
+  if (file == nullptr) {
+    LOG_ERROR("Unable to open scene %s for writing\n", path);
+    return false;
+  }
+  const bool written = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+  const bool closed = std::fclose(file) == 0;
+  if (!written || !closed) {
+    LOG_ERROR("Unable to write scene %s\n", path);
+  }
+  return written && closed;
+}
+
+// columns are read from the file straight into their chunks, with no staging copy
+inline bool load_scene_file(const char* path, ECS& ecs, game_state& state, const texture_manager& manager) {
+  std::FILE* file = std::fopen(path, "rb");
+  if (file == nullptr) {
+    LOG_ERROR("Unable to open scene %s\n", path);
+    return false;
+  }
+
+  scene_format::reader r{file};
+  const bool loaded = load_scene(ecs, state, manager, r);
+  std::fclose(file);
+  if (!loaded) {
+    LOG_ERROR("Unable to load scene %s\n", path);
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include "archetype.hpp"
+#include "job_system.hpp"
+#include "profiler.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class spatial_grid;
+struct game_state;
+
+// state outside the component tables that systems share; declared and ordered like components
+using shared_resources = component_list<spatial_grid, game_state>;
+
+template <typename... Ts>
+struct reads {};
+
+template <typename... Ts>
+struct writes {};
+
+// Runs registered systems as a dependency graph on a job_system. Two systems conflict when one writes something the
+// other reads or writes; conflicting systems keep their registration order, everything else may run concurrently.
+class scheduler {
+ public:
+  //   sim.add<reads<motion>, writes<position, spatial_grid>>("move", [&] { ecs.move(); });
+  template <typename Reads, typename Writes, typename F>
+  void add(const char* name, F&& fn) {
+    nodes_.push_back({name, access_of(Reads{}), access_of(Writes{}), std::forward<F>(fn), {}, 0, 0});
+    built_ = false;
+  }
+
+  // one pass over every system; returns once all have finished
+  void run(job_system& jobs) noexcept {
+    PROFILE_ZONE("scheduler::run");
+
+    if (!built_) {
+      build();
+    }
+    if (nodes_.empty()) {
+      return;
+    }
+
+    for (uint32_t i = 0; i < nodes_.size(); ++i) {
+      pending_[i].store(nodes_[i].deps, std::memory_order_relaxed);
+    }
+    remaining_.store(static_cast<uint32_t>(nodes_.size()), std::memory_order_relaxed);
+    jobs_ = &jobs;
+
+    for (uint32_t i = 0; i < nodes_.size(); ++i) {
+      if (nodes_[i].deps == 0) {
+        jobs.submit([this, i] { execute(i); });
+      }
+    }
+    jobs.wait_until([&] { return remaining_.load(std::memory_order_acquire) == 0; });
+  }
+
+  [[nodiscard]] uint32_t size() const noexcept { return static_cast<uint32_t>(nodes_.size()); }
+  [[nodiscard]] const char* name(uint32_t i) const noexcept { return nodes_[i].name; }
+  // wall time of system i in the last run()
+  [[nodiscard]] uint64_t last_ns(uint32_t i) const noexcept { return nodes_[i].last_ns; }
+
+ private:
+  struct access {
+    component_mask components = 0;
+    component_mask resources = 0;
+  };
+
+  template <typename T>
+  static constexpr access access_bit() noexcept {
+    static_assert(components::contains<T>() || shared_resources::contains<T>(), "not a component or shared resource");
+    if constexpr (components::contains<T>()) {
+      return {components::bit<T>(), 0};
+    } else {
+      return {0, shared_resources::bit<T>()};
+    }
+  }
+
+  template <template <typename...> typename List, typename... Ts>
+  static constexpr access access_of(List<Ts...>) noexcept {
+    access a{};
+    ((a.components |= access_bit<Ts>().components, a.resources |= access_bit<Ts>().resources), ...);
+    return a;
+  }
+
+  struct node {
+    const char* name;
+    access reads;
+    access writes;
+    std::function<void()> fn;
+    std::vector<uint32_t> dependents;
+    uint32_t deps;
+    uint64_t last_ns;
+  };
+
+  static bool overlaps(const access& a, const access& b) noexcept { return (a.components & b.components) != 0 || (a.resources & b.resources) != 0; }
+
+  static bool conflicts(const node& a, const node& b) noexcept {
+    return overlaps(a.writes, b.writes) || overlaps(a.writes, b.reads) || overlaps(a.reads, b.writes);
+  }
+
+  void build() noexcept {
+    for (auto& n : nodes_) {
+      n.dependents.clear();
+      n.deps = 0;
+    }
+
+    for (uint32_t j = 0; j < nodes_.size(); ++j) {
+      for (uint32_t i = 0; i < j; ++i) {
+        if (conflicts(nodes_[i], nodes_[j])) {
+          nodes_[i].dependents.emplace_back(j);
+          ++nodes_[j].deps;
+        }
+      }
+    }
+
+    pending_ = std::vector<std::atomic<uint32_t>>(nodes_.size());
+    built_ = true;
+  }
+
+  // jobs capture only (this, i), small enough for std::function to store without allocating
+  void execute(uint32_t i) noexcept {
+    auto& n = nodes_[i];
+
+    const uint64_t start = SDL_GetTicksNS();
+    n.fn();
+    n.last_ns = SDL_GetTicksNS() - start;
+
+    for (const auto d : n.dependents) {
+      if (pending_[d].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        jobs_->submit([this, d] { execute(d); });
+      }
+    }
+    remaining_.fetch_sub(1, std::memory_order_release);
+  }
+
+  std::vector<node> nodes_;
+  std::vector<std::atomic<uint32_t>> pending_;  // unfinished dependencies per system, this run
+  std::atomic<uint32_t> remaining_{0};
+  job_system* jobs_ = nullptr;  // the one run() is using
+  bool built_ = false;
+};
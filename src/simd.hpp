@@ -0,0 +1,434 @@
+#pragma once
+
+#include "components.hpp"
+
+#include <SDL3/SDL.h>
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SIMD_TARGET_AVX2
+#endif
+
+// Vectorized kernels over archetype columns.
+//
+// The SSE2/AVX2 paths issue the same IEEE operations in the same order as the scalar path (no FMA, exact sqrt and
+// div, no reciprocal estimates), so they match it bit for bit unless the compiler contracts the scalar code into
+// FMAs; the documented tolerance is 1e-5 relative per component per step.
+namespace simd {
+
+enum class level : uint8_t { scalar, sse2, avx2 };
+
+// per-frame target shared by every tracker
+struct track_target {
+  float x;
+  float y;
+  bool to_anchor;  // ignore x/y and relax to anchors
+};
+
+struct spring {
+  float stiffness;
+  float damping;
+  float depth;  // virtual z distance to the target plane
+};
+
+// The exact solution of x'' = -stiffness * x - damping * x' over one step, as a linear map of (offset, velocity).
+// Unlike an explicit integrator it cannot gain energy, so trackers stay stable at any tick length.
+struct spring_step {
+  float pp, pv;  // offset' = pp * offset + pv * velocity
+  float vp, vv;  // velocity' = vp * offset + vv * velocity
+};
+
+inline spring_step make_step(const spring& s, float dt) noexcept {
+  const double k = s.stiffness, c = s.damping, t = dt;
+  const double w = std::sqrt(k);  // undamped angular frequency
+  if (w == 0.0) {
+    const double decay = std::exp(-c * t);
+    return {1.f, static_cast<float>(c > 0.0 ? (1.0 - decay) / c : t), 0.f, static_cast<float>(decay)};
+  }
+
+  const double zeta = c / (2.0 * w);
+  double pp, pv, vp, vv;
+  if (std::abs(zeta - 1.0) < 1e-6) {  // critical
+    const double decay = std::exp(-w * t);
+    pp = decay * (1.0 + w * t);
+    pv = decay * t;
+    vp = -decay * k * t;
+    vv = decay * (1.0 - w * t);
+  } else if (zeta < 1.0) {  // under-damped: decaying oscillation
+    const double wd = w * std::sqrt(1.0 - zeta * zeta);
+    const double decay = std::exp(-zeta * w * t);
+    const double cs = std::cos(wd * t), sn = std::sin(wd * t);
+    pp = decay * (cs + zeta * w / wd * sn);
+    pv = decay * sn / wd;
+    vp = -decay * k / wd * sn;
+    vv = decay * (cs - zeta * w / wd * sn);
+  } else {  // over-damped: two decaying exponentials
+    const double root = w * std::sqrt(zeta * zeta - 1.0);
+    const double r1 = -zeta * w + root, r2 = -zeta * w - root;
+    const double e1 = std::exp(r1 * t), e2 = std::exp(r2 * t);
+    pp = (r1 * e2 - r2 * e1) / (r1 - r2);
+    pv = (e1 - e2) / (r1 - r2);
+    vp = r1 * r2 * (e2 - e1) / (r1 - r2);
+    vv = (r1 * e1 - r2 * e2) / (r1 - r2);
+  }
+  return {static_cast<float>(pp), static_cast<float>(pv), static_cast<float>(vp), static_cast<float>(vv)};
+}
+
+namespace scalar {
+
+inline void integrate(position* pos, motion* vel, uint32_t n, float dt) noexcept {
+  for (uint32_t i = 0; i < n; ++i) {
+    vel[i].dx += vel[i].ax * dt;
+    vel[i].dy += vel[i].ay * dt;
+
+    pos[i].x += vel[i].dx * dt;
+    pos[i].y += vel[i].dy * dt;
+  }
+}
+
+// springs each tracker towards its target by one exact step; ax/ay are left at the spring force of the new state
+inline void track(position* pos, motion* vel, mouse_tracker* anc, uint32_t n, track_target t, spring s, spring_step m) noexcept {
+  for (uint32_t i = 0; i < n; ++i) {
+    anc[i].target_x = t.to_anchor ? anc[i].anchor_x : t.x;
+    anc[i].target_y = t.to_anchor ? anc[i].anchor_y : t.y;
+
+    float x_vec = anc[i].target_x - anc[i].anchor_x;
+    float y_vec = anc[i].target_y - anc[i].anchor_y;
+
+    const float norm = std::sqrt(x_vec * x_vec + y_vec * y_vec + s.depth * s.depth);
+
+    x_vec /= norm;
+    y_vec /= norm;
+
+    const float x_target = anc[i].max_radius * x_vec + anc[i].anchor_x;
+    const float y_target = anc[i].max_radius * y_vec + anc[i].anchor_y;
+
+    const float ex = pos[i].x - x_target;
+    const float ey = pos[i].y - y_target;
+    const float dx = vel[i].dx;
+    const float dy = vel[i].dy;
+
+    pos[i].x = x_target + (m.pp * ex + m.pv * dx);
+    pos[i].y = y_target + (m.pp * ey + m.pv * dy);
+    vel[i].dx = m.vp * ex + m.vv * dx;
+    vel[i].dy = m.vp * ey + m.vv * dy;
+
+    vel[i].ax = s.stiffness * (x_target - pos[i].x) - s.damping * vel[i].dx;
+    vel[i].ay = s.stiffness * (y_target - pos[i].y) - s.damping * vel[i].dy;
+  }
+}
+
+}  // namespace scalar
+
+#ifdef SIMD_X86
+
+static_assert(sizeof(position) == 2 * sizeof(float));
+static_assert(sizeof(motion) == 4 * sizeof(float));
+static_assert(sizeof(mouse_tracker) == 5 * sizeof(float));
+
+namespace sse2 {
+
+// 4 entities per step
+inline void integrate(position* pos, motion* vel, uint32_t n, float dt) noexcept {
+  const __m128 vdt = _mm_set1_ps(dt);
+
+  uint32_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128 dx = _mm_loadu_ps(&vel[i].dx);
+    __m128 dy = _mm_loadu_ps(&vel[i + 1].dx);
+    __m128 ax = _mm_loadu_ps(&vel[i + 2].dx);
+    __m128 ay = _mm_loadu_ps(&vel[i + 3].dx);
+    _MM_TRANSPOSE4_PS(dx, dy, ax, ay);
+
+    const __m128 p01 = _mm_loadu_ps(&pos[i].x);
+    const __m128 p23 = _mm_loadu_ps(&pos[i + 2].x);
+    __m128 px = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(2, 0, 2, 0));
+    __m128 py = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(3, 1, 3, 1));
+
+    dx = _mm_add_ps(dx, _mm_mul_ps(ax, vdt));
+    dy = _mm_add_ps(dy, _mm_mul_ps(ay, vdt));
+    px = _mm_add_ps(px, _mm_mul_ps(dx, vdt));
+    py = _mm_add_ps(py, _mm_mul_ps(dy, vdt));
+
+    _mm_storeu_ps(&pos[i].x, _mm_unpacklo_ps(px, py));
+    _mm_storeu_ps(&pos[i + 2].x, _mm_unpackhi_ps(px, py));
+
+    _MM_TRANSPOSE4_PS(dx, dy, ax, ay);
+    _mm_storeu_ps(&vel[i].dx, dx);
+    _mm_storeu_ps(&vel[i + 1].dx, dy);
+    _mm_storeu_ps(&vel[i + 2].dx, ax);
+    _mm_storeu_ps(&vel[i + 3].dx, ay);
+  }
+
+  scalar::integrate(pos + i, vel + i, n - i, dt);
+}
+
+inline void track(position* pos, motion* vel, mouse_tracker* anc, uint32_t n, track_target t, spring s, spring_step m) noexcept {
+  const __m128 to_anchor = _mm_castsi128_ps(_mm_set1_epi32(t.to_anchor ? -1 : 0));
+  const __m128 tx = _mm_set1_ps(t.x);
+  const __m128 ty = _mm_set1_ps(t.y);
+  const __m128 depth2 = _mm_set1_ps(s.depth * s.depth);
+  const __m128 stiffness = _mm_set1_ps(s.stiffness);
+  const __m128 damping = _mm_set1_ps(s.damping);
+  const __m128 pp = _mm_set1_ps(m.pp), pv = _mm_set1_ps(m.pv), vp = _mm_set1_ps(m.vp), vv = _mm_set1_ps(m.vv);
+
+  uint32_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    // first four floats of each tracker: anchor_x, anchor_y, target_x, target_y
+    __m128 anc_x = _mm_loadu_ps(&anc[i].anchor_x);
+    __m128 anc_y = _mm_loadu_ps(&anc[i + 1].anchor_x);
+    __m128 tgt_x = _mm_loadu_ps(&anc[i + 2].anchor_x);
+    __m128 tgt_y = _mm_loadu_ps(&anc[i + 3].anchor_x);
+    _MM_TRANSPOSE4_PS(anc_x, anc_y, tgt_x, tgt_y);
+    const __m128 radius = _mm_set_ps(anc[i + 3].max_radius, anc[i + 2].max_radius, anc[i + 1].max_radius, anc[i].max_radius);
+
+    tgt_x = _mm_or_ps(_mm_and_ps(to_anchor, anc_x), _mm_andnot_ps(to_anchor, tx));
+    tgt_y = _mm_or_ps(_mm_and_ps(to_anchor, anc_y), _mm_andnot_ps(to_anchor, ty));
+
+    __m128 x_vec = _mm_sub_ps(tgt_x, anc_x);
+    __m128 y_vec = _mm_sub_ps(tgt_y, anc_y);
+    const __m128 norm = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x_vec, x_vec), _mm_mul_ps(y_vec, y_vec)), depth2));
+    x_vec = _mm_div_ps(x_vec, norm);
+    y_vec = _mm_div_ps(y_vec, norm);
+
+    const __m128 x_target = _mm_add_ps(_mm_mul_ps(radius, x_vec), anc_x);
+    const __m128 y_target = _mm_add_ps(_mm_mul_ps(radius, y_vec), anc_y);
+
+    const __m128 p01 = _mm_loadu_ps(&pos[i].x);
+    const __m128 p23 = _mm_loadu_ps(&pos[i + 2].x);
+    __m128 px = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(2, 0, 2, 0));
+    __m128 py = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(3, 1, 3, 1));
+
+    __m128 dx = _mm_loadu_ps(&vel[i].dx);
+    __m128 dy = _mm_loadu_ps(&vel[i + 1].dx);
+    __m128 ax = _mm_loadu_ps(&vel[i + 2].dx);
+    __m128 ay = _mm_loadu_ps(&vel[i + 3].dx);
+    _MM_TRANSPOSE4_PS(dx, dy, ax, ay);
+
+    const __m128 ex = _mm_sub_ps(px, x_target);
+    const __m128 ey = _mm_sub_ps(py, y_target);
+    px = _mm_add_ps(x_target, _mm_add_ps(_mm_mul_ps(pp, ex), _mm_mul_ps(pv, dx)));
+    py = _mm_add_ps(y_target, _mm_add_ps(_mm_mul_ps(pp, ey), _mm_mul_ps(pv, dy)));
+    dx = _mm_add_ps(_mm_mul_ps(vp, ex), _mm_mul_ps(vv, dx));
+    dy = _mm_add_ps(_mm_mul_ps(vp, ey), _mm_mul_ps(vv, dy));
+    _mm_storeu_ps(&pos[i].x, _mm_unpacklo_ps(px, py));
+    _mm_storeu_ps(&pos[i + 2].x, _mm_unpackhi_ps(px, py));
+
+    ax = _mm_sub_ps(_mm_mul_ps(stiffness, _mm_sub_ps(x_target, px)), _mm_mul_ps(damping, dx));
+    ay = _mm_sub_ps(_mm_mul_ps(stiffness, _mm_sub_ps(y_target, py)), _mm_mul_ps(damping, dy));
+
+    _MM_TRANSPOSE4_PS(dx, dy, ax, ay);
+    _mm_storeu_ps(&vel[i].dx, dx);
+    _mm_storeu_ps(&vel[i + 1].dx, dy);
+    _mm_storeu_ps(&vel[i + 2].dx, ax);
+    _mm_storeu_ps(&vel[i + 3].dx, ay);
+
+    alignas(16) float out_x[4];
+    alignas(16) float out_y[4];
+    _mm_store_ps(out_x, tgt_x);
+    _mm_store_ps(out_y, tgt_y);
+    for (uint32_t k = 0; k < 4; ++k) {
+      anc[i + k].target_x = out_x[k];
+      anc[i + k].target_y = out_y[k];
+    }
+  }
+
+  scalar::track(pos + i, vel + i, anc + i, n - i, t, s, m);
+}
+
+}  // namespace sse2
+
+namespace avx2 {
+
+// in-lane 4x4 transpose: both 128-bit halves are transposed independently
+SIMD_TARGET_AVX2 inline void transpose4(__m256& r0, __m256& r1, __m256& r2, __m256& r3) noexcept {
+  const __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+  const __m256 t1 = _mm256_unpacklo_ps(r2, r3);
+  const __m256 t2 = _mm256_unpackhi_ps(r0, r1);
+  const __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+  r0 = _mm256_castpd_ps(_mm256_unpacklo_pd(_mm256_castps_pd(t0), _mm256_castps_pd(t1)));
+  r1 = _mm256_castpd_ps(_mm256_unpackhi_pd(_mm256_castps_pd(t0), _mm256_castps_pd(t1)));
+  r2 = _mm256_castpd_ps(_mm256_unpacklo_pd(_mm256_castps_pd(t2), _mm256_castps_pd(t3)));
+  r3 = _mm256_castpd_ps(_mm256_unpackhi_pd(_mm256_castps_pd(t2), _mm256_castps_pd(t3)));
+}
+
+// low lane from entity `i + k`, high lane from `i + k + 4`; lane layout is entities [i..i+3 | i+4..i+7]
+SIMD_TARGET_AVX2 inline __m256 load_pair(const float* lo, const float* hi) noexcept {
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(lo)), _mm_loadu_ps(hi), 1);
+}
+
+SIMD_TARGET_AVX2 inline void store_pair(float* lo, float* hi, __m256 v) noexcept {
+  _mm_storeu_ps(lo, _mm256_castps256_ps128(v));
+  _mm_storeu_ps(hi, _mm256_extractf128_ps(v, 1));
+}
+
+SIMD_TARGET_AVX2 inline void load_positions(const position* pos, __m256& px, __m256& py) noexcept {
+  const __m256 p0 = _mm256_loadu_ps(&pos[0].x);  // x0 y0 x1 y1 | x2 y2 x3 y3
+  const __m256 p1 = _mm256_loadu_ps(&pos[4].x);  // x4 y4 x5 y5 | x6 y6 x7 y7
+  const __m256 a = _mm256_permute2f128_ps(p0, p1, 0x20);
+  const __m256 b = _mm256_permute2f128_ps(p0, p1, 0x31);
+  px = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+  py = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+SIMD_TARGET_AVX2 inline void store_positions(position* pos, __m256 px, __m256 py) noexcept {
+  const __m256 a = _mm256_unpacklo_ps(px, py);
+  const __m256 b = _mm256_unpackhi_ps(px, py);
+  _mm256_storeu_ps(&pos[0].x, _mm256_permute2f128_ps(a, b, 0x20));
+  _mm256_storeu_ps(&pos[4].x, _mm256_permute2f128_ps(a, b, 0x31));
+}
+
+SIMD_TARGET_AVX2 inline void load_motions(const motion* vel, __m256& dx, __m256& dy, __m256& ax, __m256& ay) noexcept {
+  dx = load_pair(&vel[0].dx, &vel[4].dx);
+  dy = load_pair(&vel[1].dx, &vel[5].dx);
+  ax = load_pair(&vel[2].dx, &vel[6].dx);
+  ay = load_pair(&vel[3].dx, &vel[7].dx);
+  transpose4(dx, dy, ax, ay);
+}
+
+SIMD_TARGET_AVX2 inline void store_motions(motion* vel, __m256 dx, __m256 dy, __m256 ax, __m256 ay) noexcept {
+  transpose4(dx, dy, ax, ay);
+  store_pair(&vel[0].dx, &vel[4].dx, dx);
+  store_pair(&vel[1].dx, &vel[5].dx, dy);
+  store_pair(&vel[2].dx, &vel[6].dx, ax);
+  store_pair(&vel[3].dx, &vel[7].dx, ay);
+}
+
+// 8 entities per step
+SIMD_TARGET_AVX2 inline void integrate(position* pos, motion* vel, uint32_t n, float dt) noexcept {
+  const __m256 vdt = _mm256_set1_ps(dt);
+
+  uint32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 dx, dy, ax, ay, px, py;
+    load_motions(vel + i, dx, dy, ax, ay);
+    load_positions(pos + i, px, py);
+
+    dx = _mm256_add_ps(dx, _mm256_mul_ps(ax, vdt));
+    dy = _mm256_add_ps(dy, _mm256_mul_ps(ay, vdt));
+    px = _mm256_add_ps(px, _mm256_mul_ps(dx, vdt));
+    py = _mm256_add_ps(py, _mm256_mul_ps(dy, vdt));
+
+    store_positions(pos + i, px, py);
+    store_motions(vel + i, dx, dy, ax, ay);
+  }
+
+  sse2::integrate(pos + i, vel + i, n - i, dt);
+}
+
+SIMD_TARGET_AVX2 inline void track(position* pos, motion* vel, mouse_tracker* anc, uint32_t n, track_target t, spring s, spring_step m) noexcept {
+  const __m256 to_anchor = _mm256_castsi256_ps(_mm256_set1_epi32(t.to_anchor ? -1 : 0));
+  const __m256 tx = _mm256_set1_ps(t.x);
+  const __m256 ty = _mm256_set1_ps(t.y);
+  const __m256 depth2 = _mm256_set1_ps(s.depth * s.depth);
+  const __m256 stiffness = _mm256_set1_ps(s.stiffness);
+  const __m256 damping = _mm256_set1_ps(s.damping);
+  const __m256 pp = _mm256_set1_ps(m.pp), pv = _mm256_set1_ps(m.pv), vp = _mm256_set1_ps(m.vp), vv = _mm256_set1_ps(m.vv);
+
+  uint32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const mouse_tracker* a = anc + i;
+    __m256 anc_x = load_pair(&a[0].anchor_x, &a[4].anchor_x);
+    __m256 anc_y = load_pair(&a[1].anchor_x, &a[5].anchor_x);
+    __m256 tgt_x = load_pair(&a[2].anchor_x, &a[6].anchor_x);
+    __m256 tgt_y = load_pair(&a[3].anchor_x, &a[7].anchor_x);
+    transpose4(anc_x, anc_y, tgt_x, tgt_y);
+    const __m256 radius =
+        _mm256_set_ps(a[7].max_radius, a[6].max_radius, a[5].max_radius, a[4].max_radius, a[3].max_radius, a[2].max_radius, a[1].max_radius, a[0].max_radius);
+
+    tgt_x = _mm256_blendv_ps(tx, anc_x, to_anchor);
+    tgt_y = _mm256_blendv_ps(ty, anc_y, to_anchor);
+
+    __m256 x_vec = _mm256_sub_ps(tgt_x, anc_x);
+    __m256 y_vec = _mm256_sub_ps(tgt_y, anc_y);
+    const __m256 norm = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x_vec, x_vec), _mm256_mul_ps(y_vec, y_vec)), depth2));
+    x_vec = _mm256_div_ps(x_vec, norm);
+    y_vec = _mm256_div_ps(y_vec, norm);
+
+    const __m256 x_target = _mm256_add_ps(_mm256_mul_ps(radius, x_vec), anc_x);
+    const __m256 y_target = _mm256_add_ps(_mm256_mul_ps(radius, y_vec), anc_y);
+
+    __m256 px, py, dx, dy, ax, ay;
+    load_positions(pos + i, px, py);
+    load_motions(vel + i, dx, dy, ax, ay);
+
+    const __m256 ex = _mm256_sub_ps(px, x_target);
+    const __m256 ey = _mm256_sub_ps(py, y_target);
+    px = _mm256_add_ps(x_target, _mm256_add_ps(_mm256_mul_ps(pp, ex), _mm256_mul_ps(pv, dx)));
+    py = _mm256_add_ps(y_target, _mm256_add_ps(_mm256_mul_ps(pp, ey), _mm256_mul_ps(pv, dy)));
+    dx = _mm256_add_ps(_mm256_mul_ps(vp, ex), _mm256_mul_ps(vv, dx));
+    dy = _mm256_add_ps(_mm256_mul_ps(vp, ey), _mm256_mul_ps(vv, dy));
+    store_positions(pos + i, px, py);
+
+    ax = _mm256_sub_ps(_mm256_mul_ps(stiffness, _mm256_sub_ps(x_target, px)), _mm256_mul_ps(damping, dx));
+    ay = _mm256_sub_ps(_mm256_mul_ps(stiffness, _mm256_sub_ps(y_target, py)), _mm256_mul_ps(damping, dy));
+
+    store_motions(vel + i, dx, dy, ax, ay);
+
+    alignas(32) float out_x[8];
+    alignas(32) float out_y[8];
+    _mm256_store_ps(out_x, tgt_x);
+    _mm256_store_ps(out_y, tgt_y);
+    for (uint32_t k = 0; k < 8; ++k) {
+      anc[i + k].target_x = out_x[k];
+      anc[i + k].target_y = out_y[k];
+    }
+  }
+
+  sse2::track(pos + i, vel + i, anc + i, n - i, t, s, m);
+}
+
+}  // namespace avx2
+
+#endif  // SIMD_X86
+
+struct kernel_table {
+  level lvl;
+  void (*integrate)(position*, motion*, uint32_t, float) noexcept;
+  void (*track)(position*, motion*, mouse_tracker*, uint32_t, track_target, spring, spring_step) noexcept;
+};
+
+inline kernel_table make_kernels(level lvl) noexcept {
+#ifdef SIMD_X86
+  if (lvl == level::avx2 && SDL_HasAVX2()) {
+    return {level::avx2, avx2::integrate, avx2::track};
+  }
+  if (lvl >= level::sse2 && SDL_HasSSE2()) {
+    return {level::sse2, sse2::integrate, sse2::track};
+  }
+#endif
+  return {level::scalar, scalar::integrate, scalar::track};
+}
+
+// best level the CPU supports, picked once; force_level() overrides it (bench_frame --simd)
+inline kernel_table& kernels() noexcept {
+  static kernel_table table = make_kernels(level::avx2);
+  return table;
+}
+
+inline level force_level(level lvl) noexcept {
+  kernels() = make_kernels(lvl);
+  return kernels().lvl;
+}
+
+inline const char* level_name(level lvl) noexcept {
+  switch (lvl) {
+    case level::avx2:
+      return "avx2";
+    case level::sse2:
+      return "sse2";
+    default:
+      return "scalar";
+  }
+}
+
+}  // namespace simd
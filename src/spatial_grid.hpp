@@ -0,0 +1,131 @@
+#pragma once
+
+#include "components.hpp"
+#include "entity.hpp"
+#include "globals.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// axis-aligned box of an object centered at pos
+struct aabb {
+  float min_x;
+  float min_y;
+  float max_x;
+  float max_y;
+
+  static aabb from(const position& pos, const object_size& dim) noexcept {
+    return {pos.x - dim.width / 2, pos.y - dim.height / 2, pos.x + dim.width / 2, pos.y + dim.height / 2};
+  }
+
+  [[nodiscard]] bool contains(float x, float y) const noexcept { return min_x <= x && x <= max_x && min_y <= y && y <= max_y; }
+};
+
+// uniform grid over the screen; objects outside it are clamped into the border cells
+class spatial_grid {
+ public:
+  static constexpr float kCellSize = 64.f;
+  static constexpr uint32_t kCols = (kScreenWidth + static_cast<uint32_t>(kCellSize) - 1) / static_cast<uint32_t>(kCellSize);
+  static constexpr uint32_t kRows = (kScreenHeight + static_cast<uint32_t>(kCellSize) - 1) / static_cast<uint32_t>(kCellSize);
+
+  spatial_grid() : cells_(kCols * kRows) {}
+
+  void insert(entity e, const aabb& box) noexcept {
+    if (e.index() >= ranges_.size()) {
+      ranges_.resize(e.index() + 1);
+    }
+
+    auto& r = ranges_[e.index()];
+    if (r.present) {
+      update(e, box);
+      return;
+    }
+
+    r = cover(box);
+    r.present = true;
+    for_each_cell(r, [&](std::vector<entity>& cell) { cell.emplace_back(e); });
+  }
+
+  // O(1) when the object stays within the same cells
+  void update(entity e, const aabb& box) noexcept {
+    if (e.index() >= ranges_.size() || !ranges_[e.index()].present) {
+      insert(e, box);
+      return;
+    }
+
+    auto& r = ranges_[e.index()];
+    auto next = cover(box);
+    next.present = true;
+    if (next == r) {
+      return;
+    }
+
+    for_each_cell(r, [&](std::vector<entity>& cell) { erase_from(cell, e); });
+    r = next;
+    for_each_cell(r, [&](std::vector<entity>& cell) { cell.emplace_back(e); });
+  }
+
+  void remove(entity e) noexcept {
+    if (e.index() >= ranges_.size() || !ranges_[e.index()].present) {
+      return;
+    }
+
+    auto& r = ranges_[e.index()];
+    for_each_cell(r, [&](std::vector<entity>& cell) { erase_from(cell, e); });
+    r.present = false;
+  }
+
+  // forgets every object, keeping the cells' storage
+  void clear() noexcept {
+    for (auto& cell : cells_) {
+      cell.clear();
+    }
+    for (auto& r : ranges_) {
+      r.present = false;
+    }
+  }
+
+  // candidates whose cells cover (x, y); callers still run the exact box test
+  template <typename F>
+  void query(float x, float y, F&& f) const noexcept {
+    for (const auto e : cells_[cell_y(y) * kCols + cell_x(x)]) {
+      f(e);
+    }
+  }
+
+ private:
+  struct cell_range {
+    uint16_t x0;
+    uint16_t y0;
+    uint16_t x1;
+    uint16_t y1;
+    bool present;
+
+    bool operator==(const cell_range&) const noexcept = default;
+  };
+
+  static uint16_t cell_x(float x) noexcept { return static_cast<uint16_t>(std::clamp(x / kCellSize, 0.f, static_cast<float>(kCols - 1))); }
+  static uint16_t cell_y(float y) noexcept { return static_cast<uint16_t>(std::clamp(y / kCellSize, 0.f, static_cast<float>(kRows - 1))); }
+
+  static cell_range cover(const aabb& box) noexcept { return {cell_x(box.min_x), cell_y(box.min_y), cell_x(box.max_x), cell_y(box.max_y), false}; }
+
+  template <typename F>
+  void for_each_cell(const cell_range& r, F&& f) noexcept {
+    for (uint32_t cy = r.y0; cy <= r.y1; ++cy) {
+      for (uint32_t cx = r.x0; cx <= r.x1; ++cx) {
+        f(cells_[cy * kCols + cx]);
+      }
+    }
+  }
+
+  static void erase_from(std::vector<entity>& cell, entity e) noexcept {
+    if (auto it = std::find(cell.begin(), cell.end(), e); it != cell.end()) {
+      *it = cell.back();
+      cell.pop_back();
+    }
+  }
+
+  std::vector<std::vector<entity>> cells_;
+  std::vector<cell_range> ranges_;  // by entity index
+};
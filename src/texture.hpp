@@ -4,8 +4,22 @@
 #include <SDL3_image/SDL_image.h>
 #include <SDL3_ttf/SDL_ttf.h>
 
+#include "asset_pack.hpp"
+#include "atlas.hpp"
+#include "job_system.hpp"
+#include "log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <condition_variable>
 #include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -51,6 +65,18 @@ class texture_manager {
  public:
   static constexpr uint32_t kNoImage = std::numeric_limits<uint32_t>::max();
 
+  texture_manager() = default;
+  texture_manager(const texture_manager&) = delete;
+  texture_manager& operator=(const texture_manager&) = delete;
+
+  ~texture_manager() {
+    loader_.reset();  // joins workers
+    for (auto& img : decoded_) {
+      SDL_DestroySurface(img.surface);
+      SDL_DestroySurface(img.padded);
+    }
+  }
+
   uint32_t load_texture(SDL_Renderer* renderer, const std::string& path) noexcept { return load_texture_named(renderer, path, ""); }
 
   uint32_t load_texture_with_color_key(SDL_Renderer* renderer, const std::string& path, uint8_t red, uint8_t green, uint8_t blue) noexcept {
@@ -65,25 +91,13 @@ class texture_manager {
   // named
   uint32_t load_texture_named(SDL_Renderer* renderer, const std::string& path, const std::string& name) noexcept {
     if (SDL_Surface* loadedSurface = IMG_Load(path.c_str()); loadedSurface == nullptr) {
-      SDL_Log("Unable to load image %s! SDL_image error: %s\n", path.c_str(), SDL_GetError());
+      LOG_ERROR("Unable to load image %s! SDL_image error: %s\n", path.c_str(), SDL_GetError());
       return kNoImage;
     } else {
-      if (SDL_Texture* internal_texture = SDL_CreateTextureFromSurface(renderer, loadedSurface); internal_texture == nullptr) {
-        SDL_Log("Unable to create texture from loaded pixels! SDL error: %s\n", SDL_GetError());
-        return kNoImage;
-      } else {
-        textures_.emplace_back(internal_texture);
-        dimentions_.emplace_back(loadedSurface->w, loadedSurface->h);
-
-        if (!name.empty()) {
-          name_to_id_[name] = textures_.size() - 1;
-        }
-      }
-
+      const auto id = store_image(renderer, loadedSurface, name);
       SDL_DestroySurface(loadedSurface);
+      return id;
     }
-
-    return textures_.size() - 1;
   }
 
   uint32_t load_texture_with_color_key_named(SDL_Renderer* renderer,
@@ -93,30 +107,18 @@ class texture_manager {
                                              uint8_t green,
                                              uint8_t blue) noexcept {
     if (SDL_Surface* loadedSurface = IMG_Load(path.c_str()); loadedSurface == nullptr) {
-      SDL_Log("Unable to load image %s! SDL_image error: %s\n", path.c_str(), SDL_GetError());
+      LOG_ERROR("Unable to load image %s! SDL_image error: %s\n", path.c_str(), SDL_GetError());
       return std::numeric_limits<uint32_t>::max();
     } else {
       if (SDL_SetSurfaceColorKey(loadedSurface, true, SDL_MapSurfaceRGB(loadedSurface, red, green, blue)) == false) {
-        SDL_Log("Unable to load image %s! SDL_image error: %s\n", path.c_str(), SDL_GetError());
+        LOG_ERROR("Unable to load image %s! SDL_image error: %s\n", path.c_str(), SDL_GetError());
         return std::numeric_limits<uint32_t>::max();
       } else {
-        if (SDL_Texture* internal_texture = SDL_CreateTextureFromSurface(renderer, loadedSurface); internal_texture == nullptr) {
-          SDL_Log("Unable to create texture from loaded pixels! SDL error: %s\n", SDL_GetError());
-          return std::numeric_limits<uint32_t>::max();
-        } else {
-          textures_.emplace_back(internal_texture);
-          dimentions_.emplace_back(loadedSurface->w, loadedSurface->h);
-
-          if (!name.empty()) {
-            name_to_id_[name] = textures_.size() - 1;
-          }
-        }
+        const auto id = store_image(renderer, loadedSurface, name);
+        SDL_DestroySurface(loadedSurface);
+        return id;
       }
-
-      SDL_DestroySurface(loadedSurface);
     }
-
-    return textures_.size() - 1;
   }
 
   uint32_t load_texture_from_text_named(SDL_Renderer* renderer,
@@ -127,21 +129,16 @@ class texture_manager {
                                         uint8_t green,
                                         uint8_t blue,
                                         uint8_t alpha) noexcept {
-    SDL_Log("textures: %zu\n", textures_.size());
+    LOG_DEBUG("textures: %zu\n", textures_.size());
     if (SDL_Surface* textSurface = TTF_RenderText_Blended(font, text.c_str(), 0, SDL_Color{red, green, blue, alpha}); textSurface == nullptr) {
-      SDL_Log("Unable to render text surface! SDL_ttf Error: %s\n", SDL_GetError());
+      LOG_ERROR("Unable to render text surface! SDL_ttf Error: %s\n", SDL_GetError());
       return std::numeric_limits<uint32_t>::max();
     } else {
       if (SDL_Texture* internal_texture = SDL_CreateTextureFromSurface(renderer, textSurface); internal_texture == nullptr) {
-        SDL_Log("Unable to create texture from rendered text! SDL Error: %s\n", SDL_GetError());
+        LOG_ERROR("Unable to create texture from rendered text! SDL Error: %s\n", SDL_GetError());
         return std::numeric_limits<uint32_t>::max();
       } else {
-        textures_.emplace_back(internal_texture);
-        dimentions_.emplace_back(textSurface->w, textSurface->h);
-
-        if (!name.empty()) {
-          name_to_id_[name] = textures_.size() - 1;
-        }
+        add_entry(texture(internal_texture), textSurface->w, textSurface->h, {kNoPage, {}}, name);
       }
 
       SDL_DestroySurface(textSurface);
@@ -164,15 +161,17 @@ class texture_manager {
     }
 
     if (SDL_Surface* textSurface = TTF_RenderText_Blended(font, text.c_str(), 0, SDL_Color{red, green, blue, alpha}); textSurface == nullptr) {
-      SDL_Log("Unable to render text surface! SDL_ttf Error: %s\n", SDL_GetError());
+      LOG_ERROR("Unable to render text surface! SDL_ttf Error: %s\n", SDL_GetError());
       return std::numeric_limits<uint32_t>::max();
     } else {
       if (SDL_Texture* internal_texture = SDL_CreateTextureFromSurface(renderer, textSurface); internal_texture == nullptr) {
-        SDL_Log("Unable to create texture from rendered text! SDL Error: %s\n", SDL_GetError());
+        LOG_ERROR("Unable to create texture from rendered text! SDL Error: %s\n", SDL_GetError());
         return std::numeric_limits<uint32_t>::max();
       } else {
         textures_[tex_id] = std::move(texture(internal_texture));
+        regions_[tex_id] = {kNoPage, {}};
         dimentions_[tex_id] = {static_cast<uint16_t>(textSurface->w), static_cast<uint16_t>(textSurface->h)};
+        forget_scaled(tex_id);
       }
 
       SDL_DestroySurface(textSurface);
@@ -181,6 +180,155 @@ class texture_manager {
     return textures_.size() - 1;
   }
 
+  // Maps a pack written by pack_assets; pixels go from the mapping straight into the atlas without decoding or copying.
+  // False if the pack is missing or invalid, so callers can fall back to loose images.
+  bool load_pack(SDL_Renderer* renderer, const char* path) noexcept {
+    asset_pack::mapped_pack pack;
+    if (!pack.open(path)) {
+      return false;
+    }
+
+    bool ok = true;
+    for (const auto& e : pack.entries()) {
+      const int w = static_cast<int>(e.width - 2 * e.padding);
+      const int h = static_cast<int>(e.height - 2 * e.padding);
+
+      // wraps the mapped pixels; nothing is copied until the upload
+      SDL_Surface* view = SDL_CreateSurfaceFrom(static_cast<int>(e.width), static_cast<int>(e.height), SDL_PIXELFORMAT_ARGB8888,
+                                                const_cast<void*>(pack.pixels(e)), static_cast<int>(e.pitch));
+      if (view == nullptr) {
+        LOG_ERROR("Unable to wrap packed image %s! SDL error: %s\n", e.name, SDL_GetError());
+        ok = false;
+        continue;
+      }
+
+      if (region reg{}; e.padding == kAtlasPadding && pack_padded(renderer, view, reg)) {
+        add_entry(texture(), w, h, reg, e.name);
+      } else if (SDL_Texture* internal_texture = e.padding == 0 ? SDL_CreateTextureFromSurface(renderer, view) : nullptr; internal_texture == nullptr) {
+        LOG_ERROR("Unable to upload packed image %s! SDL error: %s\n", e.name, SDL_GetError());
+        ok = false;
+      } else {
+        add_entry(texture(internal_texture), w, h, {kNoPage, {}}, e.name);
+      }
+      SDL_DestroySurface(view);
+    }
+
+    return ok;
+  }
+
+  // Decodes (and pads for the atlas) on worker threads. The id is valid immediately; it draws nothing until
+  // upload_ready() or wait_loads() has uploaded it on the render thread.
+  uint32_t load_texture_async(const std::string& path, const std::string& name) noexcept {
+    const auto id = add_entry(texture(), 0, 0, {kNoPage, {}}, name);
+    decode_async(id, path, false);
+    return id;
+  }
+
+  // Hot reload: decodes the image at `path` again, on a worker, for the texture named after the file (the stem, as
+  // pack_assets names them). upload_ready() swaps the new pixels in under the same id; until then the old ones draw.
+  // False when no texture has that name.
+  bool reload_texture_async(const std::string& path) noexcept {
+    const auto id = get_texture_id(std::filesystem::path(path).stem().string());
+    if (id == kNoImage) {
+      return false;
+    }
+    decode_async(id, path, true);
+    return true;
+  }
+
+  // textures swapped by hot reloads since the last call; cached layers that drew them are stale
+  uint32_t take_reloaded() noexcept { return std::exchange(reloaded_, 0); }
+
+  // uploads every finished decode; call on the render thread. Returns loads still in flight.
+  uint32_t upload_ready(SDL_Renderer* renderer) noexcept {
+    {
+      std::lock_guard lock{decoded_mutex_};
+      std::swap(uploading_, decoded_);
+    }
+
+    for (auto& img : uploading_) {
+      finish_load(renderer, img);
+      --pending_loads_;
+    }
+    uploading_.clear();
+
+    return pending_loads_;
+  }
+
+  // completion barrier for every async load issued so far; false if any failed. The loading threads are let go.
+  bool wait_loads(SDL_Renderer* renderer) noexcept {
+    while (upload_ready(renderer) > 0) {
+      std::unique_lock lock{decoded_mutex_};
+      decoded_cv_.wait(lock, [&] { return !decoded_.empty(); });
+    }
+    loader_.reset();
+    return std::exchange(failed_loads_, 0) == 0;
+  }
+
+  // rasterizes printable ASCII once into the atlas; text then draws as glyph quads with no per-update uploads
+  bool load_glyphs(SDL_Renderer* renderer, TTF_Font* font, uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha) noexcept {
+    line_height_ = static_cast<float>(TTF_GetFontHeight(font));
+
+    for (uint32_t c = kFirstGlyph; c < kFirstGlyph + kGlyphCount; ++c) {
+      auto& g = glyphs_[c - kFirstGlyph];
+      int advance = 0;
+      if (TTF_GetGlyphMetrics(font, c, nullptr, nullptr, nullptr, nullptr, &advance) == false) {
+        continue;
+      }
+      g.advance = static_cast<float>(advance);
+
+      if (c == ' ') {
+        continue;  // nothing to draw
+      }
+
+      if (SDL_Surface* glyphSurface = TTF_RenderGlyph_Blended(font, c, SDL_Color{red, green, blue, alpha}); glyphSurface == nullptr) {
+        LOG_ERROR("Unable to render glyph %c! SDL_ttf Error: %s\n", static_cast<char>(c), SDL_GetError());
+        return false;
+      } else {
+        g.tex_id = store_image(renderer, glyphSurface, "");
+        g.width = static_cast<float>(glyphSurface->w);
+        g.height = static_cast<float>(glyphSurface->h);
+        SDL_DestroySurface(glyphSurface);
+      }
+    }
+
+    return true;
+  }
+
+  // natural size of `text` in font pixels
+  [[nodiscard]] std::pair<float, float> measure_text(std::string_view text) const noexcept {
+    float w = 0.f;
+    for (const char c : text) {
+      if (const auto* g = find_glyph(c); g != nullptr) {
+        w += g->advance;
+      }
+    }
+    return {w, line_height_};
+  }
+
+  // lays `text` out to fill the box centered at (center_x, center_y); calls f(tex_id, cx, cy, w, h) per glyph quad
+  template <typename F>
+  void layout_text(std::string_view text, float center_x, float center_y, float width, float height, F&& f) const noexcept {
+    const auto [natural_w, natural_h] = measure_text(text);
+    if (natural_w <= 0.f || natural_h <= 0.f) {
+      return;
+    }
+
+    const float sx = width / natural_w;
+    const float sy = height / natural_h;
+    float pen = center_x - width / 2;
+    for (const char c : text) {
+      const auto* g = find_glyph(c);
+      if (g == nullptr) {
+        continue;
+      }
+      if (g->tex_id != kNoImage) {
+        f(g->tex_id, pen + g->width * sx / 2, center_y, g->width * sx, g->height * sy);
+      }
+      pen += g->advance * sx;
+    }
+  }
+
   void render(SDL_Renderer* renderer, uint32_t tex_id, float center_x, float center_y, float width, float height) noexcept {
     if (tex_id >= textures_.size()) {
       return;
@@ -189,9 +337,159 @@ class texture_manager {
     SDL_FRect dst_rect{center_x - static_cast<float>(width) / 2, center_y - static_cast<float>(height) / 2, static_cast<float>(width),
                        static_cast<float>(height)};
 
-    SDL_RenderTexture(renderer, textures_[tex_id].ptr(), nullptr, &dst_rect);
+    if (const auto* v = scaled_page_limit_ != 0 && !scaled_paused_ ? find_scaled(tex_id, width, height) : nullptr; v != nullptr) {
+      dst_rect = {center_x - v->width / 2.f, center_y - v->height / 2.f, static_cast<float>(v->width), static_cast<float>(v->height)};
+      SDL_RenderTexture(renderer, scaled_pages_[v->page].tex.ptr(), &v->src, &dst_rect);
+    } else if (const auto& reg = regions_[tex_id]; reg.page != kNoPage) {
+      SDL_RenderTexture(renderer, pages_[reg.page].tex.ptr(), &reg.src, &dst_rect);
+    } else {
+      SDL_RenderTexture(renderer, textures_[tex_id].ptr(), nullptr, &dst_rect);
+    }
+  }
+
+  // Batched drawing: consecutive quads that sample the same atlas page (or standalone texture) are merged into one
+  // SDL_RenderGeometry call, so draw calls follow page switches in draw order rather than sprite count.
+  void batch(SDL_Renderer* renderer, uint32_t tex_id, float center_x, float center_y, float width, float height) noexcept {
+    if (tex_id >= textures_.size()) {
+      return;
+    }
+
+    const auto& reg = regions_[tex_id];
+    SDL_Texture* source = reg.page != kNoPage ? pages_[reg.page].tex.ptr() : textures_[tex_id].ptr();
+    if (source == nullptr) {
+      return;  // still loading
+    }
+
+    float u0 = 0.f, v0 = 0.f, u1 = 1.f, v1 = 1.f;
+    if (const auto* v = scaled_page_limit_ != 0 && !scaled_paused_ ? find_scaled(tex_id, width, height) : nullptr; v != nullptr) {
+      // the pre-scaled copy, at exactly its size
+      source = scaled_pages_[v->page].tex.ptr();
+      width = v->width;
+      height = v->height;
+      u0 = v->src.x / kScaledPageSize;
+      v0 = v->src.y / kScaledPageSize;
+      u1 = (v->src.x + v->src.w) / kScaledPageSize;
+      v1 = (v->src.y + v->src.h) / kScaledPageSize;
+    } else if (reg.page != kNoPage) {
+      u0 = reg.src.x / kAtlasSize;
+      v0 = reg.src.y / kAtlasSize;
+      u1 = (reg.src.x + reg.src.w) / kAtlasSize;
+      v1 = (reg.src.y + reg.src.h) / kAtlasSize;
+    }
+
+    if (source != batch_texture_) {
+      flush(renderer);
+      batch_texture_ = source;
+    }
+
+    const float x0 = center_x - width / 2, y0 = center_y - height / 2;
+    const float x1 = x0 + width, y1 = y0 + height;
+    const SDL_FColor white{1.f, 1.f, 1.f, 1.f};
+    const int base = static_cast<int>(vertices_.size());
+
+    vertices_.push_back({{x0, y0}, white, {u0, v0}});
+    vertices_.push_back({{x1, y0}, white, {u1, v0}});
+    vertices_.push_back({{x1, y1}, white, {u1, v1}});
+    vertices_.push_back({{x0, y1}, white, {u0, v1}});
+
+    for (const int i : {0, 1, 2, 0, 2, 3}) {
+      indices_.push_back(base + i);
+    }
+  }
+
+  void flush(SDL_Renderer* renderer) noexcept {
+    if (!indices_.empty()) {
+      SDL_RenderGeometry(renderer, batch_texture_, vertices_.data(), static_cast<int>(vertices_.size()), indices_.data(), static_cast<int>(indices_.size()));
+      ++draw_calls_;
+    }
+
+    vertices_.clear();
+    indices_.clear();
+    batch_texture_ = nullptr;
+  }
+
+  // draws a texture the manager does not own, in order with the batch
+  void draw_texture(SDL_Renderer* renderer, SDL_Texture* tex, const SDL_FRect& dst) noexcept {
+    flush(renderer);
+    SDL_RenderTexture(renderer, tex, nullptr, &dst);
+    ++draw_calls_;
+  }
+
+  // draw calls issued since the last call
+  uint32_t take_draw_calls() noexcept { return std::exchange(draw_calls_, 0); }
+
+  [[nodiscard]] std::size_t page_count() const noexcept { return pages_.size(); }
+
+  // Pre-scaled copies. A quad drawn at a size other than its image's is resampled by the renderer every frame, which
+  // on the software renderer costs far more than a plain copy. With a budget set, batch() and render() draw such
+  // quads from a copy resampled once to the drawn size (rounded to whole pixels), kept in atlas pages of its own so
+  // batches still merge. Copies are made by build_scaled() the frame after first use; when the pages are full, the
+  // least recently drawn are evicted. The budget is rounded up to whole pages; 0 bytes turns it off.
+  static constexpr std::size_t kDefaultScaledBudget = 8 * 1024 * 1024;
+
+  void set_scaled_budget(std::size_t bytes) noexcept {
+    scaled_page_limit_ = static_cast<uint32_t>((bytes + kScaledPageBytes - 1) / kScaledPageBytes);
+    scaled_requests_.reserve(kMaxScaledRequests);
+    drop_scaled();
+  }
+
+  // while paused, quads sample their images as if there were no budget; the copies are kept
+  void pause_scaled(bool paused) noexcept { scaled_paused_ = paused; }
+
+  // renders the copies asked for since the last call; call once a frame, before drawing. Returns how many were made:
+  // quads drawn from them come out slightly different, so cached drawings of those quads are stale.
+  uint32_t build_scaled(SDL_Renderer* renderer) noexcept {
+    ++scaled_frame_;
+    if (scaled_unplaced_ > kMaxScaledRequests || (scaled_unplaced_ != 0 && scaled_frame_ % kScaledRetryFrames == 0)) {
+      prune_scaled();  // refused copies get asked for, and tried, again
+    }
+    if (scaled_requests_.empty()) {
+      return 0;
+    }
+
+    flush(renderer);
+    SDL_Texture* previous = SDL_GetRenderTarget(renderer);
+    uint8_t r = 0, g = 0, b = 0, a = 0;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+
+    uint32_t built = 0;
+    std::size_t unplaced = 0;
+    for (const auto& req : scaled_requests_) {
+      if (place_scaled(renderer, req.tex_id, req.width, req.height, scaled_frame_)) {
+        ++built;
+      } else {
+        scaled_requests_[unplaced++] = req;
+      }
+    }
+    scaled_requests_.resize(unplaced);
+
+    // out of room: evict if anything went undrawn last frame, else draw these unscaled from now on
+    const bool stale = std::ranges::any_of(scaled_, [&](const scaled_variant& v) { return v.page != kNoPage && v.last_used + 1 < scaled_frame_; });
+    if (!scaled_requests_.empty() && stale) {
+      built += repack_scaled(renderer);
+    } else {
+      for (const auto& req : scaled_requests_) {
+        refuse_scaled(req);
+      }
+    }
+    scaled_requests_.clear();
+
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+    SDL_SetRenderTarget(renderer, previous);
+    return built;
+  }
+
+  // forgets every copy; render targets lose their contents on device resets
+  void drop_scaled() noexcept {
+    scaled_pages_.clear();
+    scaled_.clear();
+    std::ranges::fill(scaled_heads_, kNoImage);
+    scaled_requests_.clear();
+    scaled_unplaced_ = 0;
   }
 
+  [[nodiscard]] std::size_t scaled_page_count() const noexcept { return scaled_pages_.size(); }
+
   void set_name(uint32_t tex_id, std::string name) noexcept {
     if (tex_id >= textures_.size()) {
       return;
@@ -206,6 +504,14 @@ class texture_manager {
     return kNoImage;
   }
 
+  // f(name, tex_id) for every named texture
+  template <typename F>
+  void for_each_name(F&& f) const {
+    for (const auto& [name, tex_id] : name_to_id_) {
+      f(name, tex_id);
+    }
+  }
+
   std::pair<uint16_t, uint16_t> get_texture_sizes(const std::string& name) const noexcept { return get_texture_sizes(get_texture_id(name)); }
   std::pair<uint16_t, uint16_t> get_texture_sizes(uint32_t tex_id) const noexcept {
     if (tex_id == kNoImage) {
@@ -215,7 +521,447 @@ class texture_manager {
   }
 
  private:
+  static constexpr uint32_t kNoPage = std::numeric_limits<uint32_t>::max();
+
+  struct region {
+    uint32_t page;  // kNoPage: standalone texture in textures_
+    SDL_FRect src;
+  };
+
+  struct atlas_page {
+    texture tex;
+    skyline_packer packer;
+  };
+
+  // worker output: the decoded image, plus its atlas-ready copy when it fits a page
+  struct decoded_image {
+    uint32_t id = kNoImage;
+    SDL_Surface* surface = nullptr;
+    SDL_Surface* padded = nullptr;
+    bool reload = false;  // replaces the pixels of a texture already in use
+  };
+
+  static constexpr int kScaledPageSize = 1024;
+  static constexpr std::size_t kScaledPageBytes = std::size_t{kScaledPageSize} * kScaledPageSize * 4;
+  static constexpr std::size_t kMaxScaledRequests = 64;  // per frame
+  static constexpr uint64_t kScaledRetryFrames = 120;     // refused copies are asked for again this often
+
+  struct scaled_variant {
+    uint32_t tex_id;  // kNoImage: the texture was reloaded since
+    uint16_t width;
+    uint16_t height;
+    uint32_t page;  // into scaled_pages_; kNoPage: refused or forgotten, holds no slot
+    SDL_FRect src;
+    uint64_t last_used;  // build_scaled() call count when last drawn
+    uint32_t next;       // next copy of the same texture, or kNoImage
+  };
+
+  struct scaled_request {
+    uint32_t tex_id;
+    uint16_t width;
+    uint16_t height;
+  };
+
+  static constexpr uint32_t kFirstGlyph = 32;
+  static constexpr uint32_t kGlyphCount = 95;
+
+  struct glyph {
+    uint32_t tex_id = kNoImage;
+    float advance = 0.f;
+    float width = 0.f;
+    float height = 0.f;
+  };
+
+  const glyph* find_glyph(char c) const noexcept {
+    const auto idx = static_cast<uint32_t>(static_cast<unsigned char>(c)) - kFirstGlyph;
+    return idx < kGlyphCount ? &glyphs_[idx] : nullptr;
+  }
+
+  uint32_t add_entry(texture&& tex, int w, int h, region reg, const std::string& name) noexcept {
+    textures_.emplace_back(std::move(tex));
+    dimentions_.emplace_back(static_cast<uint16_t>(w), static_cast<uint16_t>(h));
+    regions_.emplace_back(reg);
+
+    if (!name.empty()) {
+      name_to_id_[name] = textures_.size() - 1;
+    }
+    return textures_.size() - 1;
+  }
+
+  // images go into an atlas page; anything that does not fit gets its own texture
+  uint32_t store_image(SDL_Renderer* renderer, SDL_Surface* surface, const std::string& name) noexcept {
+    if (region reg{}; pack(renderer, surface, reg)) {
+      return add_entry(texture(), surface->w, surface->h, reg, name);
+    }
+
+    if (SDL_Texture* internal_texture = SDL_CreateTextureFromSurface(renderer, surface); internal_texture == nullptr) {
+      LOG_ERROR("Unable to create texture from loaded pixels! SDL error: %s\n", SDL_GetError());
+      return kNoImage;
+    } else {
+      return add_entry(texture(internal_texture), surface->w, surface->h, {kNoPage, {}}, name);
+    }
+  }
+
+  bool pack(SDL_Renderer* renderer, SDL_Surface* surface, region& reg) noexcept {
+    if (!fits_atlas(surface->w, surface->h)) {
+      return false;
+    }
+
+    SDL_Surface* padded = extrude(surface);
+    if (padded == nullptr) {
+      LOG_ERROR("Unable to pad image for atlas! SDL error: %s\n", SDL_GetError());
+      return false;
+    }
+    const bool ok = pack_padded(renderer, padded, reg);
+    SDL_DestroySurface(padded);
+    return ok;
+  }
+
+  // `padded` comes from extrude()
+  bool pack_padded(SDL_Renderer* renderer, SDL_Surface* padded, region& reg) noexcept {
+    const int w = padded->w;
+    const int h = padded->h;
+
+    SDL_Rect slot{};
+    uint32_t page = 0;
+    while (page < pages_.size() && !pages_[page].packer.insert(w, h, slot)) {
+      ++page;
+    }
+    if (page == pages_.size()) {
+      if (!add_page(renderer)) {
+        return false;
+      }
+      pages_.back().packer.insert(w, h, slot);
+    }
+
+    if (SDL_UpdateTexture(pages_[page].tex.ptr(), &slot, padded->pixels, padded->pitch) == false) {
+      LOG_ERROR("Unable to upload atlas region! SDL error: %s\n", SDL_GetError());
+      return false;
+    }
+
+    reg = {page, SDL_FRect{static_cast<float>(slot.x + kAtlasPadding), static_cast<float>(slot.y + kAtlasPadding), static_cast<float>(w - 2 * kAtlasPadding),
+                           static_cast<float>(h - 2 * kAtlasPadding)}};
+    return true;
+  }
+
+  // worker half of an async load
+  void decode_async(uint32_t id, const std::string& path, bool reload) noexcept {
+    if (loader_ == nullptr) {
+      // never the game's pool: its threads help finish each tick, and a decode picked up there would stall the frame
+      loader_ = reload ? std::make_unique<job_system>(1) : std::make_unique<job_system>();
+    }
+
+    ++pending_loads_;
+    loader_->submit([this, id, path, reload] {
+      decoded_image img{id, IMG_Load(path.c_str()), nullptr, reload};
+      if (img.surface == nullptr) {
+        LOG_ERROR("Unable to load image %s! SDL_image error: %s\n", path.c_str(), SDL_GetError());
+      } else if (fits_atlas(img.surface->w, img.surface->h)) {
+        img.padded = extrude(img.surface);
+      }
+
+      {
+        std::lock_guard lock{decoded_mutex_};
+        decoded_.emplace_back(img);
+      }
+      decoded_cv_.notify_one();
+    });
+  }
+
+  // the padded page rectangle pack_padded() took for `reg`
+  static SDL_Rect slot_of(const region& reg) noexcept {
+    return {static_cast<int>(reg.src.x) - kAtlasPadding, static_cast<int>(reg.src.y) - kAtlasPadding, static_cast<int>(reg.src.w) + 2 * kAtlasPadding,
+            static_cast<int>(reg.src.h) + 2 * kAtlasPadding};
+  }
+
+  // render thread half of an async load. A reload of the same size overwrites its atlas slot in place; otherwise the
+  // old slot is released and the image packed again. A reload that fails to decode keeps the old pixels; one that
+  // decodes but cannot be uploaded leaves the texture empty.
+  void finish_load(SDL_Renderer* renderer, decoded_image& img) noexcept {
+    if (img.surface == nullptr) {
+      failed_loads_ += !img.reload;
+    } else if (const region old = regions_[img.id]; img.reload && img.padded != nullptr && old.page != kNoPage &&
+                                                      old.src.w == static_cast<float>(img.surface->w) && old.src.h == static_cast<float>(img.surface->h)) {
+      const SDL_Rect slot = slot_of(old);
+      if (SDL_UpdateTexture(pages_[old.page].tex.ptr(), &slot, img.padded->pixels, img.padded->pitch) == false) {
+        LOG_ERROR("Unable to upload atlas region! SDL error: %s\n", SDL_GetError());
+      } else {
+        forget_scaled(img.id);
+        ++reloaded_;
+      }
+    } else {
+      if (img.reload && old.page != kNoPage) {
+        // the old slot is reused if the new image fits it
+        pages_[old.page].packer.release(slot_of(old));
+        regions_[img.id] = {kNoPage, {}};
+      }
+
+      bool uploaded = true;
+      if (region reg{}; img.padded != nullptr && pack_padded(renderer, img.padded, reg)) {
+        textures_[img.id] = texture();
+        regions_[img.id] = reg;
+      } else if (SDL_Texture* internal_texture = SDL_CreateTextureFromSurface(renderer, img.surface); internal_texture == nullptr) {
+        LOG_ERROR("Unable to create texture from loaded pixels! SDL error: %s\n", SDL_GetError());
+        uploaded = false;
+      } else {
+        textures_[img.id] = texture(internal_texture);
+        regions_[img.id] = {kNoPage, {}};
+      }
+
+      if (uploaded || !img.reload) {
+        dimentions_[img.id] = {static_cast<uint16_t>(img.surface->w), static_cast<uint16_t>(img.surface->h)};
+      }
+      failed_loads_ += !uploaded && !img.reload;
+      if (uploaded && img.reload) {
+        forget_scaled(img.id);
+        ++reloaded_;
+      }
+    }
+
+    SDL_DestroySurface(img.surface);
+    SDL_DestroySurface(img.padded);
+    img = {};
+  }
+
+  // the copy of tex_id drawn at width x height, if there is one; asks for it otherwise
+  const scaled_variant* find_scaled(uint32_t tex_id, float width, float height) noexcept {
+    const long w = std::lround(width);
+    const long h = std::lround(height);
+    if ((w == dimentions_[tex_id].width && h == dimentions_[tex_id].height) || w < 1 || h < 1 || w + 2 * kAtlasPadding > kScaledPageSize ||
+        h + 2 * kAtlasPadding > kScaledPageSize) {
+      return nullptr;
+    }
+
+    for (uint32_t i = tex_id < scaled_heads_.size() ? scaled_heads_[tex_id] : kNoImage; i != kNoImage; i = scaled_[i].next) {
+      if (auto& v = scaled_[i]; v.width == w && v.height == h) {
+        v.last_used = scaled_frame_;
+        return v.page != kNoPage ? &v : nullptr;
+      }
+    }
+
+    const scaled_request req{tex_id, static_cast<uint16_t>(w), static_cast<uint16_t>(h)};
+    if (scaled_requests_.size() < kMaxScaledRequests && std::ranges::none_of(scaled_requests_, [&](const scaled_request& r) {
+          return r.tex_id == req.tex_id && r.width == req.width && r.height == req.height;
+        })) {
+      scaled_requests_.push_back(req);
+    }
+    return nullptr;
+  }
+
+  bool place_scaled(SDL_Renderer* renderer, uint32_t tex_id, uint16_t w, uint16_t h, uint64_t last_used) noexcept {
+    SDL_Rect slot{};
+    uint32_t page = 0;
+    while (page < scaled_pages_.size() && !scaled_pages_[page].packer.insert(w + 2 * kAtlasPadding, h + 2 * kAtlasPadding, slot)) {
+      ++page;
+    }
+    if (page == scaled_pages_.size()) {
+      if (page >= scaled_page_limit_ || !add_scaled_page(renderer)) {
+        return false;
+      }
+      scaled_pages_.back().packer.insert(w + 2 * kAtlasPadding, h + 2 * kAtlasPadding, slot);
+    }
+
+    // the padding stays transparent
+    const SDL_FRect dst{static_cast<float>(slot.x + kAtlasPadding), static_cast<float>(slot.y + kAtlasPadding), static_cast<float>(w), static_cast<float>(h)};
+    if (!render_scaled(renderer, tex_id, scaled_pages_[page].tex.ptr(), dst)) {
+      scaled_pages_[page].packer.release(slot);
+      return false;
+    }
+    link_scaled({tex_id, w, h, page, dst, last_used, kNoImage});
+    return true;
+  }
+
+  // Clears the pages and packs again: copies drawn last frame, then the pending requests, then older copies, most
+  // recently drawn first. Whatever no longer fits is evicted. Returns the requests placed.
+  uint32_t repack_scaled(SDL_Renderer* renderer) noexcept {
+    auto& old = repacking_;
+    std::swap(old, scaled_);  // both keep their capacity
+    std::erase_if(old, [](const scaled_variant& v) { return v.page == kNoPage; });
+    scaled_unplaced_ = 0;
+    std::ranges::sort(old, [](const scaled_variant& a, const scaled_variant& b) { return a.last_used > b.last_used; });
+    const auto recent = std::ranges::partition_point(old, [&](const scaled_variant& v) { return v.last_used + 1 >= scaled_frame_; });
+
+    std::ranges::fill(scaled_heads_, kNoImage);
+    for (auto& page : scaled_pages_) {
+      page.packer = skyline_packer(kScaledPageSize, kScaledPageSize);
+      SDL_SetRenderTarget(renderer, page.tex.ptr());
+      SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0x00);
+      SDL_RenderClear(renderer);
+    }
+
+    for (auto it = old.begin(); it != recent; ++it) {
+      place_scaled(renderer, it->tex_id, it->width, it->height, it->last_used);
+    }
+    uint32_t placed = 0;
+    for (const auto& req : scaled_requests_) {
+      if (place_scaled(renderer, req.tex_id, req.width, req.height, scaled_frame_)) {
+        ++placed;
+      } else {
+        refuse_scaled(req);
+      }
+    }
+    for (auto it = recent; it != old.end(); ++it) {
+      place_scaled(renderer, it->tex_id, it->width, it->height, it->last_used);
+    }
+
+    LOG_DEBUG("Repacked pre-scaled textures: %zu kept of %zu\n", scaled_.size() - (scaled_requests_.size() - placed), old.size());
+    old.clear();
+    return placed;
+  }
+
+  void link_scaled(scaled_variant v) noexcept {
+    if (v.tex_id >= scaled_heads_.size()) {
+      scaled_heads_.resize(textures_.size(), kNoImage);
+    }
+    v.next = scaled_heads_[v.tex_id];
+    scaled_heads_[v.tex_id] = static_cast<uint32_t>(scaled_.size());
+    scaled_.push_back(v);
+  }
+
+  // drawn resampled until the next prune
+  void refuse_scaled(const scaled_request& req) noexcept {
+    link_scaled({req.tex_id, req.width, req.height, kNoPage, {}, scaled_frame_, kNoImage});
+    ++scaled_unplaced_;
+  }
+
+  // after the texture changed: its copies give their slots back, and their entries go at the next prune
+  void forget_scaled(uint32_t tex_id) noexcept {
+    if (tex_id >= scaled_heads_.size()) {
+      return;
+    }
+    for (uint32_t i = std::exchange(scaled_heads_[tex_id], kNoImage); i != kNoImage; i = scaled_[i].next) {
+      auto& v = scaled_[i];
+      if (v.page != kNoPage) {
+        scaled_pages_[v.page].packer.release(slot_of({v.page, v.src}));
+      }
+      v.tex_id = kNoImage;
+      v.page = kNoPage;
+      ++scaled_unplaced_;
+    }
+  }
+
+  // drops the entries that hold no slot
+  void prune_scaled() noexcept {
+    std::erase_if(scaled_, [](const scaled_variant& v) { return v.page == kNoPage; });
+    std::ranges::fill(scaled_heads_, kNoImage);
+    for (uint32_t i = 0; i < scaled_.size(); ++i) {
+      scaled_[i].next = std::exchange(scaled_heads_[scaled_[i].tex_id], i);
+    }
+    scaled_unplaced_ = 0;
+  }
+
+  // Resamples the image into `dst` of `target`. Downscales halve first: at exactly half, bilinear filtering averages
+  // 2x2 texels, so every source texel counts; the last step goes to the exact size.
+  bool render_scaled(SDL_Renderer* renderer, uint32_t tex_id, SDL_Texture* target, const SDL_FRect& dst) noexcept {
+    const auto& reg = regions_[tex_id];
+    SDL_Texture* source = reg.page != kNoPage ? pages_[reg.page].tex.ptr() : textures_[tex_id].ptr();
+    if (source == nullptr) {
+      return false;
+    }
+    SDL_FRect from = reg.page != kNoPage
+                         ? reg.src
+                         : SDL_FRect{0.f, 0.f, static_cast<float>(dimentions_[tex_id].width), static_cast<float>(dimentions_[tex_id].height)};
+
+    std::array<texture, 2> steps;  // the source of a step must outlive it
+    for (std::size_t i = 0; from.w >= 2 * dst.w || from.h >= 2 * dst.h; i ^= 1) {
+      const SDL_FRect to{0.f, 0.f, std::max(dst.w, std::floor(from.w / 2)), std::max(dst.h, std::floor(from.h / 2))};
+      SDL_Texture* step = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, static_cast<int>(to.w), static_cast<int>(to.h));
+      if (step == nullptr) {
+        LOG_ERROR("Unable to create scaling target! SDL error: %s\n", SDL_GetError());
+        return false;
+      }
+      copy_scaled(renderer, source, from, step, to);
+      steps[i] = texture(step);
+      source = step;
+      from = to;
+    }
+    copy_scaled(renderer, source, from, target, dst);
+    return true;
+  }
+
+  // plain linear copy: straight alpha goes through untouched
+  static void copy_scaled(SDL_Renderer* renderer, SDL_Texture* source, const SDL_FRect& from, SDL_Texture* target, const SDL_FRect& to) noexcept {
+    SDL_BlendMode blend = SDL_BLENDMODE_BLEND;
+    SDL_ScaleMode scale = SDL_SCALEMODE_LINEAR;
+    SDL_GetTextureBlendMode(source, &blend);
+    SDL_GetTextureScaleMode(source, &scale);
+    SDL_SetTextureBlendMode(source, SDL_BLENDMODE_NONE);
+    SDL_SetTextureScaleMode(source, SDL_SCALEMODE_LINEAR);
+
+    SDL_SetRenderTarget(renderer, target);
+    SDL_RenderTexture(renderer, source, &from, &to);
+
+    SDL_SetTextureBlendMode(source, blend);
+    SDL_SetTextureScaleMode(source, scale);
+  }
+
+  bool add_scaled_page(SDL_Renderer* renderer) noexcept {
+    SDL_Texture* tex = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, kScaledPageSize, kScaledPageSize);
+    if (tex == nullptr) {
+      LOG_ERROR("Unable to create pre-scaled page! SDL error: %s\n", SDL_GetError());
+      return false;
+    }
+    SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureScaleMode(tex, SDL_SCALEMODE_NEAREST);  // only ever drawn 1:1
+
+    SDL_SetRenderTarget(renderer, tex);
+    SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0x00);
+    SDL_RenderClear(renderer);
+
+    scaled_pages_.push_back({texture(tex), skyline_packer(kScaledPageSize, kScaledPageSize)});
+    return true;
+  }
+
+  bool add_page(SDL_Renderer* renderer) noexcept {
+    SDL_Texture* tex = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, kAtlasSize, kAtlasSize);
+    if (tex == nullptr) {
+      LOG_ERROR("Unable to create atlas page! SDL error: %s\n", SDL_GetError());
+      return false;
+    }
+    SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+
+    // static textures start undefined
+    std::vector<uint32_t> clear(static_cast<std::size_t>(kAtlasSize) * kAtlasSize, 0);
+    SDL_UpdateTexture(tex, nullptr, clear.data(), kAtlasSize * sizeof(uint32_t));
+
+    pages_.push_back({texture(tex), skyline_packer(kAtlasSize, kAtlasSize)});
+    return true;
+  }
+
   std::vector<texture> textures_;
   std::vector<dim> dimentions_;
+  std::vector<region> regions_;
   std::unordered_map<std::string, uint32_t> name_to_id_;
+
+  std::vector<atlas_page> pages_;
+
+  // pre-scaled copies
+  std::vector<atlas_page> scaled_pages_;  // render targets
+  std::vector<scaled_variant> scaled_;
+  std::vector<scaled_variant> repacking_;
+  std::vector<uint32_t> scaled_heads_;  // by texture id: first copy in scaled_, or kNoImage
+  std::vector<scaled_request> scaled_requests_;
+  uint32_t scaled_page_limit_ = 0;  // 0: off
+  uint32_t scaled_unplaced_ = 0;    // entries in scaled_ holding no slot
+  uint64_t scaled_frame_ = 0;
+  bool scaled_paused_ = false;
+
+  std::array<glyph, kGlyphCount> glyphs_{};
+  float line_height_ = 0.f;
+
+  // batch under construction
+  std::vector<SDL_Vertex> vertices_;
+  std::vector<int> indices_;
+  SDL_Texture* batch_texture_ = nullptr;
+  uint32_t draw_calls_ = 0;
+
+  // async loads
+  std::mutex decoded_mutex_;
+  std::condition_variable decoded_cv_;
+  std::vector<decoded_image> decoded_;    // guarded by decoded_mutex_
+  std::vector<decoded_image> uploading_;  // render thread only
+  uint32_t pending_loads_ = 0;
+  uint32_t failed_loads_ = 0;
+  uint32_t reloaded_ = 0;
+  std::unique_ptr<job_system> loader_;  // startup loads until wait_loads(); then one thread for hot reloads
 };
\ No newline at end of file
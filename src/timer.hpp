@@ -52,4 +52,39 @@ class timer {
 
   bool paused_{false};
   bool started_{false};
+};
+
+// Holds frames to a fixed period against absolute deadlines, so misses do not accumulate into drift. Sleeps most of
+// the wait, then spins the last kSpinNs on SDL_GetTicksNS so scheduler wake-up latency stays out of frame times.
+class frame_pacer {
+ public:
+  static constexpr uint64_t kSpinNs = 2'000'000;
+
+  // period 0: no pacing (uncapped, or VSync doing it)
+  explicit frame_pacer(uint64_t period_ns) noexcept : period_ns_{period_ns}, deadline_{SDL_GetTicksNS() + period_ns} {}
+
+  void wait() noexcept {
+    if (period_ns_ == 0) {
+      return;
+    }
+
+    const uint64_t now = SDL_GetTicksNS();
+    if (now >= deadline_) {
+      // late: keep the cadence after a small miss, restart it after a stall
+      deadline_ = now - deadline_ < period_ns_ ? deadline_ + period_ns_ : now + period_ns_;
+      return;
+    }
+
+    if (deadline_ - now > kSpinNs) {
+      SDL_DelayNS(deadline_ - now - kSpinNs);
+    }
+    while (SDL_GetTicksNS() < deadline_) {
+      SDL_CPUPauseInstruction();
+    }
+    deadline_ += period_ns_;
+  }
+
+ private:
+  uint64_t period_ns_;
+  uint64_t deadline_;
 };
\ No newline at end of file
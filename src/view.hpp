@@ -0,0 +1,118 @@
+#pragma once
+
+#include "archetype.hpp"
+#include "entity.hpp"
+#include "job_system.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Typed query over every table holding at least Cs. Components listed const come out as const references and
+// pointers, so a system's signature says what it writes. Each query instantiates its own loop over raw column
+// pointers, one chunk at a time: no per-row dispatch, and the inner loops see plain arrays the compiler can vectorize.
+//
+//   ecs.view<position, const motion>().each([](position& p, const motion& m) { ... });
+//   ecs.view<const position, previous_position>().par_chunks([](uint32_t n, const position* p, previous_position* q) { ... });
+template <typename... Cs>
+class component_view {
+ public:
+  static constexpr component_mask kMask = components::mask<Cs...>();
+  static constexpr uint32_t kRowsPerJob = 4096;
+
+  static_assert(archetype::kChunkRows % kRowsPerJob == 0, "job ranges must not cross a column chunk");
+
+  component_view(std::vector<archetype>& tables, job_system* jobs) noexcept : tables_{tables}, jobs_{jobs} {}
+
+  // the same query skipping tables that also hold any of Xs
+  template <typename... Xs>
+  [[nodiscard]] component_view without() const noexcept {
+    component_view v = *this;
+    v.excluded_ |= components::mask<Xs...>();
+    return v;
+  }
+
+  // f(Cs&...) for every row
+  template <typename F>
+  void each(F&& f) const {
+    chunks([&](uint32_t n, Cs*... cols) {
+      for (uint32_t i = 0; i < n; ++i) {
+        f(cols[i]...);
+      }
+    });
+  }
+
+  // f(entity, Cs&...) for every row
+  template <typename F>
+  void each_entity(F&& f) const {
+    for (auto& arch : tables_) {
+      if (matches(arch)) {
+        for (uint32_t begin = 0; begin < arch.size(); begin += archetype::kChunkRows) {
+          const uint32_t n = std::min(arch.size() - begin, archetype::kChunkRows);
+          const entity* ids = &arch.entities[begin];
+          call_rows(arch, begin, n, [&](Cs*... cols) {
+            for (uint32_t i = 0; i < n; ++i) {
+              f(ids[i], cols[i]...);
+            }
+          });
+        }
+      }
+    }
+  }
+
+  // f(n, Cs*...) over runs of n contiguous rows, on the calling thread
+  template <typename F>
+  void chunks(F&& f) const {
+    for (auto& arch : tables_) {
+      if (matches(arch)) {
+        for (uint32_t begin = 0; begin < arch.size(); begin += archetype::kChunkRows) {
+          const uint32_t n = std::min(arch.size() - begin, archetype::kChunkRows);
+          call_rows(arch, begin, n, [&](Cs*... cols) { f(n, cols...); });
+        }
+      }
+    }
+  }
+
+  // chunks() with big tables split across the job system, kRowsPerJob rows at a time; f runs concurrently
+  template <typename F>
+  void par_chunks(F&& f) const {
+    if (jobs_ == nullptr) {
+      chunks(f);
+      return;
+    }
+    for (auto& arch : tables_) {
+      if (matches(arch) && arch.size() != 0) {
+        jobs_->parallel_for(arch.size(), kRowsPerJob, [&](uint32_t begin, uint32_t end) {
+          call_rows(arch, begin, end - begin, [&](Cs*... cols) { f(end - begin, cols...); });
+        });
+      }
+    }
+  }
+
+  // rows matched, over all tables
+  [[nodiscard]] uint32_t size() const noexcept {
+    uint32_t n = 0;
+    for (const auto& arch : tables_) {
+      if (matches(arch)) {
+        n += arch.size();
+      }
+    }
+    return n;
+  }
+
+ private:
+  // g(Cs*...) with each column's pointer at row `begin`; rows [begin, begin + n) are contiguous
+  template <typename G>
+  static void call_rows(archetype& arch, uint32_t begin, uint32_t n, G&& g) {
+    if (n != 0) {
+      g(static_cast<Cs*>(&arch.column<std::remove_const_t<Cs>>()[begin])...);
+    }
+  }
+
+  [[nodiscard]] bool matches(const archetype& arch) const noexcept { return arch.has(kMask) && (arch.mask & excluded_) == 0; }
+
+  std::vector<archetype>& tables_;
+  job_system* jobs_;
+  component_mask excluded_ = 0;
+};